@@ -0,0 +1,61 @@
+/**
+ * @file AdcSampler.cpp
+ * @brief Implementación de la adquisición continua del ADC.
+ */
+
+#include "AdcSampler.h"
+
+AdcSampler::AdcSampler(uint8_t pin) : adcPin(pin), sum(0), pending(0), latest(0), blockCount(0) {}
+
+void AdcSampler::begin() {
+#if defined(__AVR__) && defined(ADCSRA)
+    uint8_t channel = adcPin >= A0 ? adcPin - A0 : adcPin;
+    uint8_t oldSREG = SREG;
+    cli();
+    ADMUX = bit(REFS0) | (channel & 0x07); ///< Referencia AVcc, como analogRead()
+#if defined(MUX5)
+    ADCSRB = (channel & 0x08 ? bit(MUX5) : 0) | bit(ADTS2); ///< Disparo: desborde del Timer0
+#else
+    ADCSRB = bit(ADTS2);
+#endif
+#if defined(DIDR0)
+    if (channel < 8) DIDR0 |= bit(channel); ///< Sin buffer digital en el pin: menos consumo
+#endif
+    ADCSRA = bit(ADEN) | bit(ADATE) | bit(ADIE) | bit(ADIF) |
+             bit(ADPS2) | bit(ADPS1) | bit(ADPS0); ///< Reloj del ADC a 125 kHz
+    SREG = oldSREG;
+#endif
+}
+
+uint16_t AdcSampler::read12() const {
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+#endif
+    uint16_t value = latest;
+    if (blockCount == 0 && pending) {
+        value = ((uint32_t)sum * OVERSAMPLE / pending) >> 2; ///< Promedio parcial escalado
+    }
+#if defined(__AVR__)
+    SREG = oldSREG;
+#endif
+    return value;
+}
+
+uint16_t AdcSampler::blocks() const {
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+#endif
+    uint16_t n = blockCount;
+#if defined(__AVR__)
+    SREG = oldSREG;
+#endif
+    return n;
+}
+
+#if defined(__AVR__) && defined(ADC_vect)
+ISR(ADC_vect) {
+    lightAdc.onConversion(ADC);
+}
+#endif
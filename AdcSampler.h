@@ -0,0 +1,72 @@
+/**
+ * @file AdcSampler.h
+ * @brief Adquisición continua de un canal del ADC por interrupción.
+ *
+ * analogRead() detiene la CPU ~112 µs por conversión. Aquí el ADC se
+ * dispara solo con cada desborde del Timer0 (el mismo que lleva millis(),
+ * ~976 Hz) y la ISR de fin de conversión acumula 16 muestras; cada bloque
+ * completo deja un valor de 12 bits efectivos, unos 61 por segundo. Leer
+ * el último valor no cuesta una conversión. Mientras esté activo no se
+ * debe llamar a analogRead() en ningún canal.
+ */
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Sobremuestreo de un canal analógico.
+ */
+class AdcSampler {
+public:
+    static const uint8_t OVERSAMPLE = 16; ///< Muestras por valor (4^2: dos bits extra)
+    static const uint16_t MAX12 = 4092; ///< Valor máximo de 12 bits (16 · 1023 / 4)
+
+    /**
+     * @param pin Pin analógico (A0–A15).
+     */
+    explicit AdcSampler(uint8_t pin);
+
+    /**
+     * @brief Configura el ADC en disparo automático por el Timer0.
+     */
+    void begin();
+
+    /**
+     * @brief Acumula una conversión.
+     *
+     * La llama la ISR del ADC; en el host la llama la simulación.
+     */
+    void onConversion(uint16_t sample) {
+        sum += sample;
+        if (++pending == OVERSAMPLE) {
+            latest = sum >> 2; ///< Suma de 14 bits → 12 bits
+            sum = 0;
+            pending = 0;
+            blockCount++;
+        }
+    }
+
+    /**
+     * @brief Último valor de 12 bits (0–4092).
+     *
+     * Antes del primer bloque completo devuelve el promedio parcial.
+     */
+    uint16_t read12() const;
+
+    uint16_t read10() const { return (read12() + 2) >> 2; } ///< Último valor redondeado a 10 bits
+    uint16_t blocks() const; ///< Valores completos desde begin()
+    uint8_t pin() const { return adcPin; } ///< Pin analógico del canal
+
+private:
+    uint8_t adcPin; ///< Pin analógico
+    volatile uint16_t sum; ///< Suma del bloque en curso
+    volatile uint8_t pending; ///< Conversiones del bloque en curso
+    volatile uint16_t latest; ///< Último valor de 12 bits
+    volatile uint16_t blockCount; ///< Bloques completos
+};
+
+extern AdcSampler lightAdc; ///< Canal del fotoresistor (definido en el sketch)
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file AlarmRules.cpp
+ * @brief Implementación del motor de reglas de alarma.
+ */
+
+#include "AlarmRules.h"
+
+AlarmRules alarms;
+
+AlarmRules::AlarmRules() : rules(nullptr), ruleCount(0), known(0), pending(0) {
+    memset(first, 0, sizeof(first));
+}
+
+bool AlarmRules::begin(const AlarmRule* table, uint8_t count) {
+    if (count > MAX_RULES) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (table[i].channel >= MAX_CHANNELS) return false;
+    }
+    rules = table;
+    ruleCount = count;
+
+    // Índice por canal: conteo por canal y luego cada regla en su tramo.
+    memset(first, 0, sizeof(first));
+    for (uint8_t i = 0; i < count; i++) first[table[i].channel + 1]++;
+    for (uint8_t c = 0; c < MAX_CHANNELS; c++) first[c + 1] += first[c];
+    uint8_t next[MAX_CHANNELS];
+    memcpy(next, first, sizeof(next));
+    for (uint8_t i = 0; i < count; i++) order[next[table[i].channel]++] = i;
+
+    memset(state, 0, sizeof(state));
+    known = 0;
+    pending = 0;
+    return true;
+}
+
+void AlarmRules::update(uint8_t channel, int16_t value) {
+    if (channel >= MAX_CHANNELS) {
+        return;
+    }
+    uint8_t bitMask = 1 << channel;
+    if ((known & bitMask) && last[channel] == value) {
+        return; ///< Sin cambio: nada que evaluar
+    }
+    last[channel] = value;
+    known |= bitMask;
+    unsigned long now = millis();
+    for (uint8_t k = first[channel]; k < first[channel + 1]; k++) {
+        evaluate(order[k], value, now);
+    }
+}
+
+void AlarmRules::refresh() {
+    unsigned long now = millis();
+    for (uint8_t c = 0; c < MAX_CHANNELS; c++) {
+        if (!(known & (1 << c))) continue;
+        for (uint8_t k = first[c]; k < first[c + 1]; k++) {
+            evaluate(order[k], last[c], now);
+        }
+    }
+}
+
+void AlarmRules::service() {
+    if (!pending) {
+        return;
+    }
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        if ((state[i] & PENDING) && now - since[i] >= rules[i].minDurationMs) {
+            emit(i, true);
+        }
+    }
+}
+
+void AlarmRules::acknowledge() {
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        if (!(state[i] & ACTIVE) || !(rules[i].flags & LATCH)) continue;
+        if (state[i] & CLEARED) {
+            emit(i, false); ///< Ya estaba normalizada
+        } else {
+            state[i] |= ACKED;
+        }
+    }
+}
+
+bool AlarmRules::actionActive(uint8_t action) const {
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        if ((state[i] & ACTIVE) && rules[i].action == action) return true;
+    }
+    return false;
+}
+
+uint8_t AlarmRules::topPriority() const {
+    uint8_t top = 0;
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        if ((state[i] & ACTIVE) && rules[i].priority > top) top = rules[i].priority;
+    }
+    return top;
+}
+
+void AlarmRules::evaluate(uint8_t rule, int16_t value, unsigned long now) {
+    const AlarmRule& r = rules[rule];
+    int32_t v = value; ///< Sin desborde al sumar la histéresis
+    bool above = r.comparator == ABOVE;
+    bool trips = above ? v > r.threshold : v < r.threshold;
+    bool clears = above ? v <= (int32_t)r.threshold - r.hysteresis : v >= (int32_t)r.threshold + r.hysteresis;
+    uint8_t& s = state[rule];
+
+    if (s & ACTIVE) {
+        if (!clears) {
+            s &= ~CLEARED; ///< Volvió a salir del rango antes del reconocimiento
+        } else if (!(r.flags & LATCH) || (s & ACKED)) {
+            emit(rule, false);
+        } else {
+            s |= CLEARED; ///< Espera el reconocimiento
+        }
+        return;
+    }
+    if (!trips) {
+        if (s & PENDING) {
+            s &= ~PENDING; ///< No duró lo suficiente
+            pending--;
+        }
+        return;
+    }
+    if (r.minDurationMs == 0) {
+        emit(rule, true);
+    } else if (!(s & PENDING)) {
+        s |= PENDING;
+        since[rule] = now;
+        pending++;
+    }
+}
+
+void AlarmRules::emit(uint8_t rule, bool raised) {
+    if (state[rule] & PENDING) pending--;
+    state[rule] = raised ? ACTIVE : 0;
+    AlarmEvent e = {rule, rules[rule].action, rules[rule].priority, raised};
+    queue.push(e);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file AlarmRules.h
+ * @brief Motor de reglas de alarma por canal, con prioridades y enclavamiento.
+ *
+ * Cada regla compara el valor filtrado de un canal contra un umbral con
+ * histéresis y, opcionalmente, exige que la condición dure un tiempo
+ * mínimo. El sketch informa cada canal con update() solo cuando su valor
+ * cambia; se evalúan únicamente las reglas de ese canal, que un índice por
+ * canal armado en begin() recorre sin buscar. Cada activación o
+ * liberación deja un `AlarmEvent` en una cola fija que consumen la
+ * pantalla, los LEDs y el buzzer. No usa memoria dinámica.
+ *
+ * Una regla enclavada (`LATCH`) no se libera al normalizarse la condición
+ * sino cuando además fue reconocida con acknowledge().
+ */
+
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+#include <Arduino.h>
+#include "RingBuffer.h"
+
+/**
+ * @brief Regla de alarma.
+ *
+ * La tabla pertenece al sketch, que puede cambiar umbrales en el lugar y
+ * llamar a `AlarmRules::refresh()`.
+ */
+struct AlarmRule {
+    uint8_t channel; ///< Canal que evalúa
+    uint8_t comparator; ///< `AlarmRules::ABOVE` o `AlarmRules::BELOW`
+    int16_t threshold; ///< Se activa al pasar este valor
+    int16_t hysteresis; ///< Margen que debe volver para liberarse
+    uint16_t minDurationMs; ///< Tiempo que debe cumplirse antes de activarse (0 = de inmediato)
+    uint8_t priority; ///< Mayor número, mayor prioridad
+    uint8_t action; ///< Reacción; la interpreta quien consume los eventos
+    uint8_t flags; ///< `AlarmRules::LATCH`
+};
+
+/**
+ * @brief Activación o liberación de una regla.
+ */
+struct AlarmEvent {
+    uint8_t rule; ///< Índice de la regla en la tabla
+    uint8_t action; ///< Copia de `AlarmRule::action`
+    uint8_t priority; ///< Copia de `AlarmRule::priority`
+    bool raised; ///< true al activarse, false al liberarse
+};
+
+/**
+ * @brief Evaluador incremental de la tabla de reglas.
+ */
+class AlarmRules {
+public:
+    static const uint8_t MAX_RULES = 12; ///< Reglas de la tabla
+    static const uint8_t MAX_CHANNELS = 8; ///< Canales distintos
+    static const uint8_t QUEUE_SIZE = 16; ///< Posiciones de la cola de eventos
+
+    /**
+     * @brief Comparación de una regla.
+     */
+    enum Comparator : uint8_t {
+        ABOVE, ///< Activa si valor > umbral; libera si valor <= umbral - histéresis
+        BELOW ///< Activa si valor < umbral; libera si valor >= umbral + histéresis
+    };
+
+    /**
+     * @brief Opciones de una regla.
+     */
+    enum Flag : uint8_t {
+        LATCH = 1 ///< Sigue activa hasta reconocerla
+    };
+
+    AlarmRules();
+
+    /**
+     * @brief Toma la tabla de reglas y arma el índice por canal.
+     *
+     * Reinicia el estado de todas las reglas.
+     *
+     * @return false si la tabla o algún canal exceden los límites.
+     */
+    bool begin(const AlarmRule* table, uint8_t count);
+
+    /**
+     * @brief Informa el valor filtrado de un canal.
+     *
+     * Si no cambió no evalúa nada; si cambió evalúa solo las reglas del
+     * canal.
+     */
+    void update(uint8_t channel, int16_t value);
+
+    /**
+     * @brief Reevalúa todas las reglas con el último valor de cada canal.
+     *
+     * Tras cambiar umbrales en la tabla.
+     */
+    void refresh();
+
+    /**
+     * @brief Activa las reglas cuya condición ya cumplió su duración mínima.
+     *
+     * Se llama periódicamente; sin reglas pendientes no recorre nada.
+     */
+    void service();
+
+    /**
+     * @brief Reconoce las reglas enclavadas activas.
+     *
+     * Las que ya no cumplen la condición se liberan; las demás se liberan
+     * en cuanto se normalicen.
+     */
+    void acknowledge();
+
+    bool pop(AlarmEvent& event) { return queue.pop(event); } ///< Extrae el evento más antiguo
+    bool active(uint8_t rule) const { return rule < ruleCount && (state[rule] & ACTIVE); } ///< Regla activa
+    bool actionActive(uint8_t action) const; ///< Hay una regla activa con esa acción
+    uint8_t topPriority() const; ///< Prioridad de la regla activa más alta (0 si ninguna)
+    uint16_t overflows() const { return queue.overflows(); } ///< Eventos perdidos por cola llena
+
+private:
+    /**
+     * @brief Bits de `state`.
+     */
+    enum StateBit : uint8_t {
+        ACTIVE = 1, ///< Activa (se emitió el evento)
+        PENDING = 2, ///< Cumple la condición pero no su duración
+        ACKED = 4, ///< Enclavada y reconocida: se libera al normalizarse
+        CLEARED = 8 ///< Enclavada con la condición ya normalizada
+    };
+
+    void evaluate(uint8_t rule, int16_t value, unsigned long now); ///< Aplica una regla a un valor
+    void emit(uint8_t rule, bool raised); ///< Cambia el estado y encola el evento
+
+    const AlarmRule* rules;
+    uint8_t ruleCount;
+    uint8_t order[MAX_RULES]; ///< Reglas ordenadas por canal
+    uint8_t first[MAX_CHANNELS + 1]; ///< Reglas del canal c: order[first[c]] .. order[first[c + 1] - 1]
+    int16_t last[MAX_CHANNELS]; ///< Último valor de cada canal
+    uint8_t known; ///< Canales con valor (un bit por canal)
+    uint8_t state[MAX_RULES]; ///< Bits `StateBit` de cada regla
+    unsigned long since[MAX_RULES]; ///< Inicio de la condición pendiente
+    uint8_t pending; ///< Reglas pendientes
+    RingBuffer<AlarmEvent, QUEUE_SIZE> queue; ///< Cola motor → consumidores
+};
+
+extern AlarmRules alarms; ///< Reglas de alarma del sistema
+
+#endif
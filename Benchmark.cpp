@@ -0,0 +1,89 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Implementación del banco de pruebas con el Timer1.
+ */
+
+#include "Benchmark.h"
+
+#if defined(BENCHMARK)
+
+Benchmark bench;
+
+static void vacia() {}
+
+Benchmark::Benchmark() : overflows(0), overheadCycles(0) {}
+
+void Benchmark::begin() {
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    TCCR1A = 0; ///< Modo normal, sin salidas PWM
+    TCCR1B = bit(CS10); ///< Sin preescalador: una cuenta por ciclo
+    TCNT1 = 0;
+    overflows = 0;
+    TIFR1 = bit(TOV1);
+    TIMSK1 = bit(TOIE1);
+    SREG = oldSREG;
+#endif
+    overheadCycles = 0;
+    overheadCycles = measure(vacia, 16).minCycles; ///< Se descuenta de cada medición
+}
+
+uint32_t Benchmark::cycles() const {
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    uint16_t low = TCNT1;
+    uint16_t high = overflows;
+    if ((TIFR1 & bit(TOV1)) && low < 0x8000) { ///< Desborde aún no atendido por la ISR
+        high++;
+    }
+    SREG = oldSREG;
+    return ((uint32_t)high << 16) | low;
+#else
+    return micros() * (F_CPU / 1000000UL);
+#endif
+}
+
+Benchmark::Result Benchmark::measure(BenchFn fn, uint16_t iterations, BenchFn prepare) {
+    Result r = {0xFFFFFFFF, 0, 0, iterations};
+    for (uint16_t i = 0; i < iterations; i++) {
+        if (prepare) prepare();
+        uint32_t start = cycles();
+        fn();
+        uint32_t elapsed = cycles() - start;
+        elapsed = elapsed > overheadCycles ? elapsed - overheadCycles : 0;
+        if (elapsed < r.minCycles) r.minCycles = elapsed;
+        if (elapsed > r.maxCycles) r.maxCycles = elapsed;
+        r.totalCycles += elapsed;
+    }
+    if (iterations == 0) r.minCycles = 0;
+    return r;
+}
+
+void Benchmark::run(Print& out, const char* name, BenchFn fn, uint16_t iterations, BenchFn prepare) {
+    report(out, name, measure(fn, iterations, prepare));
+}
+
+void Benchmark::report(Print& out, const char* name, const Result& r) {
+    const float cyclesPerUs = F_CPU / 1000000.0;
+    out.print("bench ");
+    out.print(name);
+    out.print(" n=");
+    out.print((unsigned int)r.iterations);
+    out.print(" min=");
+    out.print(r.minCycles / cyclesPerUs, 1);
+    out.print(" mean=");
+    out.print(r.iterations ? r.totalCycles / r.iterations / cyclesPerUs : 0, 1);
+    out.print(" max=");
+    out.print(r.maxCycles / cyclesPerUs, 1);
+    out.print(" us\r\n");
+}
+
+#if defined(__AVR__)
+ISR(TIMER1_OVF_vect) {
+    bench.overflows++;
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file Benchmark.h
+ * @brief Medición de ciclos en el equipo con el Timer1.
+ *
+ * Solo se compila cuando se define `BENCHMARK` (por ejemplo con
+ * `-DBENCHMARK` en las opciones del compilador). El Timer1 corre libre sin
+ * preescalador, de modo que cada cuenta es un ciclo de CPU (62,5 ns a
+ * 16 MHz); su desborde extiende el contador a 32 bits. Mientras el banco
+ * de pruebas está activo el Timer1 no está disponible para PWM en los
+ * pines 11 y 12.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+
+#if defined(BENCHMARK)
+
+#ifndef BENCHMARK_ITERATIONS
+#define BENCHMARK_ITERATIONS 50 ///< Repeticiones por prueba
+#endif
+
+/**
+ * @brief Banco de pruebas de tiempo de ejecución.
+ */
+class Benchmark {
+public:
+    typedef void (*BenchFn)(); ///< Función medida o de preparación
+
+    /**
+     * @brief Resultado de una prueba, en ciclos de CPU.
+     */
+    struct Result {
+        uint32_t minCycles; ///< Ejecución más rápida
+        uint32_t maxCycles; ///< Ejecución más lenta
+        uint64_t totalCycles; ///< Suma de todas las ejecuciones
+        uint16_t iterations; ///< Ejecuciones medidas
+    };
+
+    Benchmark();
+
+    /**
+     * @brief Toma el Timer1 y mide el costo de la propia medición.
+     */
+    void begin();
+
+    uint32_t cycles() const; ///< Ciclos desde begin() (32 bits)
+
+    /**
+     * @brief Mide @p fn varias veces.
+     *
+     * @param fn Función medida.
+     * @param iterations Repeticiones.
+     * @param prepare Se llama antes de cada repetición, fuera de la medición.
+     */
+    Result measure(BenchFn fn, uint16_t iterations, BenchFn prepare = 0);
+
+    /**
+     * @brief Mide @p fn e imprime `bench <nombre> n= min= mean= max= us`.
+     */
+    void run(Print& out, const char* name, BenchFn fn, uint16_t iterations = BENCHMARK_ITERATIONS,
+             BenchFn prepare = 0);
+
+    static void report(Print& out, const char* name, const Result& r); ///< Imprime un resultado
+
+    volatile uint16_t overflows; ///< Desbordes del Timer1 (parte alta del contador)
+
+private:
+    uint32_t overheadCycles; ///< Costo de medir una función vacía
+};
+
+extern Benchmark bench; ///< Banco de pruebas del sistema
+
+#endif
+
+#endif
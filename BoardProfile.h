@@ -0,0 +1,73 @@
+/**
+ * @file BoardProfile.h
+ * @brief Perfiles de hardware: mapa de pines y tipo de sensor por variante.
+ *
+ * Cada perfil es una estructura con constantes; BoardProfile<P> agrega los
+ * tipos FastPin<> de las salidas y entradas digitales, de modo que el pin,
+ * su puerto y su máscara quedan fijos al compilar. El sketch usa siempre
+ * `Board`, que se elige con una bandera de compilación:
+ *
+ * - (ninguna): `MegaRevA`, el cableado original con DHT22.
+ * - `-DBOARD_MEGA_DHT11`: `MegaDht11`, el mismo cableado con un DHT11.
+ *
+ * El firmware usa el Timer3, Serial1 y los pines 22–36, que solo tiene el
+ * ATmega2560; por eso no hay un perfil para el Uno.
+ */
+
+#ifndef BOARD_PROFILE_H
+#define BOARD_PROFILE_H
+
+#include <Arduino.h>
+#include <DHT.h>
+#include "FastPin.h"
+
+#if defined(__AVR__) && !defined(__AVR_ATmega2560__)
+#error "Este firmware requiere un ATmega2560 (Arduino Mega)"
+#endif
+
+/**
+ * @brief Placa original: Arduino Mega 2560 con DHT22.
+ */
+struct MegaRevA {
+    static const uint8_t KEYPAD_ROW0 = 22, KEYPAD_ROW1 = 24, KEYPAD_ROW2 = 26, KEYPAD_ROW3 = 28; ///< Filas del keypad
+    static const uint8_t KEYPAD_COL0 = 30, KEYPAD_COL1 = 32, KEYPAD_COL2 = 34, KEYPAD_COL3 = 36; ///< Columnas del keypad
+    static const uint8_t LCD_RS = 12, LCD_EN = 11, LCD_D4 = 5, LCD_D5 = 4, LCD_D6 = 3, LCD_D7 = 2; ///< LCD en modo de 4 bits
+    static const uint8_t DHT_PIN = 13; ///< Sensor de temperatura y humedad
+    static const uint8_t DHT_TYPE = DHT22; ///< Modelo del sensor
+    static const uint8_t LED_GREEN = 9; ///< LED verde
+    static const uint8_t LED_RED = 10; ///< LED rojo
+    static const uint8_t LED_BLUE = 8; ///< LED azul
+    static const uint8_t BUZZER = 6; ///< Buzzer (tone() usa el Timer2)
+    static const uint8_t PHOTO_RESISTOR = A0; ///< Fotoresistor
+    static const uint8_t INFRARED = 14; ///< Sensor infrarrojo (PCINT10)
+    static const uint8_t HALL = 15; ///< Sensor Hall (PCINT9)
+    static const uint8_t BUS_DE = 7; ///< DE/RE del transceptor RS-485
+};
+
+/**
+ * @brief Variante con DHT11 en lugar de DHT22.
+ */
+struct MegaDht11 : MegaRevA {
+    static const uint8_t DHT_TYPE = DHT11;
+};
+
+/**
+ * @brief Perfil con los pines digitales resueltos al compilar.
+ */
+template <class P>
+struct BoardProfile : P {
+    typedef FastPin<P::LED_GREEN> LedGreen;
+    typedef FastPin<P::LED_RED> LedRed;
+    typedef FastPin<P::LED_BLUE> LedBlue;
+    typedef FastPin<P::BUZZER> Buzzer;
+    typedef FastPin<P::INFRARED> Infrared;
+    typedef FastPin<P::HALL> Hall;
+};
+
+#if defined(BOARD_MEGA_DHT11)
+typedef BoardProfile<MegaDht11> Board; ///< Perfil de la compilación
+#else
+typedef BoardProfile<MegaRevA> Board; ///< Perfil de la compilación
+#endif
+
+#endif
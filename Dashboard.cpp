@@ -0,0 +1,102 @@
+/**
+ * @file Dashboard.cpp
+ * @brief Implementación del tablero de páginas.
+ */
+
+#include "Dashboard.h"
+
+/**
+ * @brief Mapas de los caracteres propios, en el orden de `Dashboard::Glyph`.
+ */
+static const uint8_t GLYPHS[][8] PROGMEM = {
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10}, ///< GLYPH_BAR1
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18}, ///< GLYPH_BAR2
+    {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C}, ///< GLYPH_BAR3
+    {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E}, ///< GLYPH_BAR4
+    {0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00}, ///< GLYPH_DEGREE
+    {0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00}, ///< GLYPH_BELL
+    {0x10, 0x10, 0x10, 0x15, 0x12, 0x15, 0x00, 0x00}, ///< GLYPH_LUX
+};
+
+Dashboard::Dashboard(LcdBuffer& lcd)
+    : lcd(lcd), pages(nullptr), pageCount(0), current(0), sinceMs(0), holding(false) {}
+
+bool Dashboard::begin(DashboardPage* table, uint8_t count) {
+    if (count == 0 || count > MAX_PAGES) {
+        return false;
+    }
+    for (uint8_t i = 0; i < sizeof(GLYPHS) / sizeof(GLYPHS[0]); i++) {
+        lcd.defineGlyph(GLYPH_BAR1 + i, GLYPHS[i]);
+    }
+    pages = table;
+    pageCount = count;
+    start();
+    return true;
+}
+
+void Dashboard::start() {
+    select(0, false);
+}
+
+void Dashboard::update() {
+    if (!pageCount) {
+        return;
+    }
+    unsigned long now = millis();
+    if (holding) {
+        if (now - sinceMs < HOLD_MS) return;
+        holding = false; ///< Se reanuda: la página actual ya cumplió su permanencia
+    } else if (now - sinceMs < pages[current].dwellMs) {
+        return;
+    }
+    select(current + 1 < pageCount ? current + 1 : 0, false);
+}
+
+void Dashboard::draw() {
+    if (!pageCount) {
+        return;
+    }
+    lcd.clear();
+    pages[current].draw(lcd);
+}
+
+void Dashboard::next() {
+    select(current + 1 < pageCount ? current + 1 : 0, true);
+}
+
+void Dashboard::previous() {
+    select(current ? current - 1 : pageCount - 1, true);
+}
+
+void Dashboard::show(uint8_t page) {
+    if (page < pageCount) {
+        select(page, true);
+    }
+}
+
+void Dashboard::select(uint8_t page, bool manual) {
+    current = page;
+    sinceMs = millis();
+    holding = manual;
+}
+
+void Dashboard::bar(LcdBuffer& lcd, uint8_t col, uint8_t row, uint8_t cells,
+                    int32_t value, int32_t lo, int32_t hi) {
+    int32_t pixels = 0;
+    if (hi > lo) {
+        if (value < lo) value = lo;
+        if (value > hi) value = hi;
+        pixels = (value - lo) * cells * BAR_STEPS / (hi - lo);
+    }
+    lcd.setCursor(col, row);
+    for (uint8_t i = 0; i < cells; i++) {
+        int32_t n = pixels - (int32_t)i * BAR_STEPS; ///< Píxeles que caen en este carácter
+        if (n >= BAR_STEPS) {
+            lcd.write(GLYPH_FULL);
+        } else if (n > 0) {
+            lcd.write((uint8_t)(GLYPH_BAR1 + n - 1));
+        } else {
+            lcd.write(' ');
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file Dashboard.h
+ * @brief Tablero de páginas del LCD con rotación automática y navegación.
+ *
+ * Cada página es una función que dibuja las dos filas en el framebuffer a
+ * partir de valores ya guardados (filtros, contadores, cachés); ninguna
+ * lee un sensor, así que dibujar en cada tick es barato y el framebuffer
+ * solo envía los caracteres que cambian. update() pasa a la página
+ * siguiente cuando vence su permanencia; navegar con el teclado pausa la
+ * rotación durante `HOLD_MS`.
+ *
+ * begin() carga en la CGRAM los caracteres propios de `Glyph`: barras de
+ * una a cuatro columnas de píxeles, el símbolo de grados, una campana y
+ * "lx". El código 0 no se usa porque termina las cadenas.
+ */
+
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <Arduino.h>
+#include "LcdBuffer.h"
+
+/**
+ * @brief Página del tablero.
+ *
+ * La tabla pertenece al sketch, que puede cambiar las permanencias en el
+ * lugar.
+ */
+struct DashboardPage {
+    void (*draw)(LcdBuffer& lcd); ///< Dibuja la página con valores en caché
+    uint16_t dwellMs; ///< Permanencia en la rotación automática
+};
+
+/**
+ * @brief Rotación y navegación de las páginas.
+ */
+class Dashboard {
+public:
+    static const uint8_t MAX_PAGES = 8; ///< Páginas de la tabla
+    static const unsigned long HOLD_MS = 20000; ///< Pausa de la rotación tras navegar
+    static const uint8_t BAR_STEPS = 5; ///< Columnas de píxeles por carácter
+    static const uint8_t GLYPH_FULL = 0xFF; ///< Bloque lleno de la ROM del HD44780
+
+    /**
+     * @brief Caracteres propios cargados en la CGRAM.
+     */
+    enum Glyph : uint8_t {
+        GLYPH_BAR1 = 1, ///< Barra de una columna; GLYPH_BAR1 + n - 1 tiene n columnas
+        GLYPH_BAR2,
+        GLYPH_BAR3,
+        GLYPH_BAR4,
+        GLYPH_DEGREE, ///< Grados
+        GLYPH_BELL, ///< Campana (alarma)
+        GLYPH_LUX ///< "lx" en un carácter
+    };
+
+    explicit Dashboard(LcdBuffer& lcd);
+
+    /**
+     * @brief Carga los caracteres propios y toma la tabla de páginas.
+     *
+     * El LCD ya debe estar inicializado.
+     *
+     * @return false si la tabla está vacía o excede `MAX_PAGES`.
+     */
+    bool begin(DashboardPage* table, uint8_t count);
+
+    void start(); ///< Vuelve a la primera página y reanuda la rotación
+
+    /**
+     * @brief Pasa a la página siguiente si venció la permanencia.
+     *
+     * No dibuja; la rotación sigue aunque otro texto tape el tablero.
+     */
+    void update();
+
+    void draw(); ///< Dibuja la página actual en el framebuffer
+
+    void next(); ///< Página siguiente; pausa la rotación
+    void previous(); ///< Página anterior; pausa la rotación
+    void show(uint8_t page); ///< Salta a una página; pausa la rotación
+
+    uint8_t page() const { return current; } ///< Página actual
+    uint8_t count() const { return pageCount; } ///< Páginas de la tabla
+    bool held() const { return holding; } ///< La rotación está en pausa
+
+    /**
+     * @brief Dibuja una barra horizontal con resolución de un píxel.
+     *
+     * @param cells Caracteres que ocupa la barra.
+     * @param value Valor; se recorta a [lo, hi].
+     */
+    static void bar(LcdBuffer& lcd, uint8_t col, uint8_t row, uint8_t cells,
+                    int32_t value, int32_t lo, int32_t hi);
+
+private:
+    void select(uint8_t page, bool manual); ///< Cambia de página y reinicia la permanencia
+
+    LcdBuffer& lcd;
+    DashboardPage* pages;
+    uint8_t pageCount;
+    uint8_t current; ///< Página mostrada
+    unsigned long sinceMs; ///< Inicio de la permanencia o de la pausa
+    bool holding; ///< Navegación manual reciente
+};
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file DhtSampler.cpp
+ * @brief Implementación del servicio de muestreo del DHT.
+ */
+
+#include "DhtSampler.h"
+
+DhtSampler::DhtSampler(uint8_t pin, uint8_t type, unsigned long periodMs)
+    : dht(pin, type), periodMs(periodMs), lastAttempt(0), failCount(0), hasSample(false) {
+    sample.temperature = NAN;
+    sample.humidity = NAN;
+    sample.timestamp = 0;
+    setPeriod(periodMs);
+}
+
+void DhtSampler::begin() {
+    dht.begin(); ///< Inicializa el sensor de temperatura y humedad
+    lastAttempt = millis() - periodMs; ///< Permite la primera lectura de inmediato
+}
+
+bool DhtSampler::update() {
+    unsigned long now = millis();
+    if (now - lastAttempt < periodMs) { ///< Respetar el periodo de muestreo
+        return false;
+    }
+    lastAttempt = now;
+
+    // Una sola transacción: read() consulta el bus y las lecturas
+    // siguientes reutilizan el resultado dentro del mismo periodo.
+    if (!dht.read(true)) {
+        failCount++;
+        return false;
+    }
+    float h = dht.readHumidity(); ///< Lee la humedad desde la caché de la librería
+    float t = dht.readTemperature(); ///< Lee la temperatura desde la caché de la librería
+    if (isnan(h) || isnan(t)) { ///< Rechaza lecturas inválidas
+        failCount++;
+        return false;
+    }
+
+    sample.temperature = t;
+    sample.humidity = h;
+    sample.timestamp = now;
+    hasSample = true;
+    return true;
+}
+
+bool DhtSampler::valid() const {
+    return hasSample && millis() - sample.timestamp <= periodMs * STALE_PERIODS;
+}
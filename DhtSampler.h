@@ -0,0 +1,73 @@
+/**
+ * @file DhtSampler.h
+ * @brief Servicio de muestreo del sensor DHT con caché.
+ *
+ * Cada transacción del DHT22 tarda varios milisegundos con las
+ * interrupciones deshabilitadas y el sensor no entrega datos nuevos más
+ * rápido que cada 2 segundos. Este servicio es el único dueño del bus:
+ * hace una lectura combinada por periodo, descarta los NaN y guarda la
+ * última muestra válida para que los demás módulos la consulten sin
+ * tocar el sensor.
+ */
+
+#ifndef DHT_SAMPLER_H
+#define DHT_SAMPLER_H
+
+#include <Arduino.h>
+#include <DHT.h>
+
+/**
+ * @brief Muestra de temperatura y humedad.
+ */
+struct DhtSample {
+    float temperature; ///< Temperatura en °C
+    float humidity; ///< Humedad relativa en %
+    unsigned long timestamp; ///< Instante de la lectura (millis)
+};
+
+/**
+ * @brief Muestreador del DHT con límite de frecuencia.
+ */
+class DhtSampler {
+public:
+    static const unsigned long DEFAULT_PERIOD_MS = 2000; ///< Periodo mínimo del DHT22
+    static const uint8_t STALE_PERIODS = 3; ///< Periodos sin lectura válida antes de invalidar
+
+    DhtSampler(uint8_t pin, uint8_t type, unsigned long periodMs = DEFAULT_PERIOD_MS);
+
+    void begin(); ///< Inicializa el sensor
+
+    /**
+     * @brief Lee el sensor si ya pasó el periodo de muestreo.
+     *
+     * @return true si se obtuvo una muestra nueva y válida.
+     */
+    bool update();
+
+    /**
+     * @brief Indica si hay una muestra válida y reciente.
+     *
+     * La muestra deja de ser válida si pasan @c STALE_PERIODS periodos
+     * sin una lectura correcta.
+     */
+    bool valid() const;
+
+    const DhtSample& last() const { return sample; } ///< Última muestra válida
+    float temperature() const { return sample.temperature; } ///< Última temperatura válida
+    float humidity() const { return sample.humidity; } ///< Última humedad válida
+    unsigned int failures() const { return failCount; } ///< Lecturas fallidas acumuladas
+    unsigned long period() const { return periodMs; } ///< Periodo de muestreo
+    void setPeriod(unsigned long ms) { periodMs = ms < DEFAULT_PERIOD_MS ? DEFAULT_PERIOD_MS : ms; } ///< Cambia el periodo (mínimo 2 s)
+
+private:
+    DHT dht; ///< Controlador del sensor
+    DhtSample sample; ///< Última muestra válida
+    unsigned long periodMs; ///< Periodo de muestreo
+    unsigned long lastAttempt; ///< Instante del último intento de lectura
+    unsigned int failCount; ///< Lecturas fallidas acumuladas
+    bool hasSample; ///< Indica si alguna vez hubo una lectura válida
+};
+
+extern DhtSampler dhtSampler; ///< Servicio de muestreo del sensor ambiental
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file Diagnostics.cpp
+ * @brief Implementación de los contadores de diagnóstico.
+ */
+
+#include "Diagnostics.h"
+#include "DhtSampler.h"
+
+Diagnostics diag;
+
+Diagnostics::Diagnostics() : loopStartUs(0), state(0), stateSinceMs(0) {
+    memset(&s, 0, sizeof(s));
+}
+
+void Diagnostics::begin(uint8_t initial) {
+    state = initial < MAX_STATES ? initial : MAX_STATES - 1;
+    stateSinceMs = millis();
+    s.stateEntries[state]++;
+}
+
+void Diagnostics::enterState(uint8_t next) {
+    unsigned long now = millis();
+    s.stateDwellMs[state] += now - stateSinceMs;
+    stateSinceMs = now;
+    state = next < MAX_STATES ? next : MAX_STATES - 1;
+    if (s.stateEntries[state] != 0xFFFF) s.stateEntries[state]++;
+}
+
+const Diagnostics::Stats& Diagnostics::stats() {
+    unsigned long now = millis();
+    s.stateDwellMs[state] += now - stateSinceMs; ///< Lleva al día el estado actual
+    stateSinceMs = now;
+    s.dhtFailures = dhtSampler.failures();
+    return s;
+}
+
+void Diagnostics::reset() {
+    memset(&s, 0, sizeof(s));
+    stateSinceMs = millis();
+}
+
+uint8_t Diagnostics::bucketFor(uint32_t us) {
+    if (us >> 16) {
+        return LOOP_BUCKETS - 1;
+    }
+    // log2 por partes sobre 16 bits: a lo sumo cuatro comparaciones.
+    uint16_t v = us;
+    uint8_t b = 0;
+    if (v >= 0x100) { v >>= 8; b = 8; }
+    if (v >= 0x10) { v >>= 4; b += 4; }
+    if (v >= 0x4) { v >>= 2; b += 2; }
+    if (v >= 0x2) { b += 1; }
+    return b < LOOP_BUCKETS ? b : LOOP_BUCKETS - 1;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file Diagnostics.h
+ * @brief Contadores de diagnóstico siempre activos.
+ *
+ * Registra la duración de cada iteración activa del bucle (la ejecución
+ * de las tareas, sin el reposo) en un histograma de potencias de 2, las
+ * entradas y el tiempo acumulado en cada estado, y las lecturas fallidas
+ * del DHT. Todo vive en una estructura fija que se puede mostrar o
+ * transmitir tal cual. Medir una iteración cuesta una lectura de micros()
+ * y unas pocas comparaciones.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Contadores de diagnóstico.
+ */
+class Diagnostics {
+public:
+    static const uint8_t LOOP_BUCKETS = 16; ///< Intervalo b: menos de 2^(b+1) µs; el último satura
+    static const uint8_t MAX_STATES = 8; ///< Estados que se pueden contar
+
+    /**
+     * @brief Contadores acumulados desde el arranque o el último reset().
+     */
+    struct Stats {
+        uint32_t loops; ///< Iteraciones medidas
+        uint32_t loopMaxUs; ///< Iteración más lenta
+        uint16_t loopHist[LOOP_BUCKETS]; ///< Iteraciones por intervalo (saturado)
+        uint16_t stateEntries[MAX_STATES]; ///< Entradas a cada estado
+        uint32_t stateDwellMs[MAX_STATES]; ///< Tiempo acumulado en cada estado
+        uint16_t dhtFailures; ///< Lecturas fallidas del DHT
+    };
+
+    Diagnostics();
+
+    /**
+     * @brief Inicia la cuenta de tiempo en el estado inicial.
+     */
+    void begin(uint8_t state);
+
+    void loopBegin() { loopStartUs = micros(); } ///< Marca el inicio de una iteración
+
+    /**
+     * @brief Cierra la iteración iniciada con loopBegin().
+     */
+    void loopEnd() {
+        uint32_t us = micros() - loopStartUs;
+        if (us > s.loopMaxUs) s.loopMaxUs = us;
+        uint16_t& bucket = s.loopHist[bucketFor(us)];
+        if (bucket != 0xFFFF) bucket++;
+        s.loops++;
+    }
+
+    /**
+     * @brief Registra la entrada a un estado y cierra el tiempo del anterior.
+     */
+    void enterState(uint8_t state);
+
+    /**
+     * @brief Contadores al día (incluye el tiempo en el estado actual).
+     */
+    const Stats& stats();
+
+    void reset(); ///< Pone en cero todos los contadores
+
+    static uint8_t bucketFor(uint32_t us); ///< Intervalo del histograma para una duración
+
+private:
+    Stats s;
+    uint32_t loopStartUs; ///< Inicio de la iteración en curso
+    uint8_t state; ///< Estado actual
+    unsigned long stateSinceMs; ///< Instante desde el que no se sumó tiempo al estado actual
+};
+
+extern Diagnostics diag; ///< Diagnóstico del sistema
+
+#endif
@@ -31,9 +31,32 @@
  * en estas condiciones.
  */
 
-#include <Keypad.h>
 #include <LiquidCrystal.h>
 #include <DHT.h>
+#include "BoardProfile.h"
+#include "Scheduler.h"
+#include "TonePlayer.h"
+#include "DhtSampler.h"
+#include "LightSensor.h"
+#include "PinEvents.h"
+#include "LcdBuffer.h"
+#include "Dashboard.h"
+#include "PinEntry.h"
+#include "PowerManager.h"
+#include "KeypadScanner.h"
+#include "EepromLayout.h"
+#include "TelemetryLog.h"
+#include "TelemetryStream.h"
+#include "Benchmark.h"
+#include "Diagnostics.h"
+#include "SensorFilter.h"
+#include "AdcSampler.h"
+#include "SensorBus.h"
+#include "Settings.h"
+#include "LedAnimator.h"
+#include "Watchdog.h"
+#include "AlarmRules.h"
+#include "Lockout.h"
 
 // Configuración del keypad
 const byte ROWS = 4; ///< Cuatro filas
@@ -44,37 +67,356 @@ char keys[ROWS][COLS] = {
     {'7','8','9', 'C'},
     {'*','0','#', 'D'}
 };
-byte rowPins[ROWS] = {22, 24, 26, 28}; ///< Conectar a las salidas de fila del keypad
-byte colPins[COLS] = {30, 32, 34, 36}; ///< Conectar a las salidas de columna del keypad
+byte rowPins[ROWS] = {Board::KEYPAD_ROW0, Board::KEYPAD_ROW1, Board::KEYPAD_ROW2, Board::KEYPAD_ROW3}; ///< Conectar a las salidas de fila del keypad
+byte colPins[COLS] = {Board::KEYPAD_COL0, Board::KEYPAD_COL1, Board::KEYPAD_COL2, Board::KEYPAD_COL3}; ///< Conectar a las salidas de columna del keypad
 
-Keypad keypad = Keypad(makeKeymap(keys), rowPins, colPins, ROWS, COLS);
+KeypadScanner keypad(&keys[0][0], rowPins, colPins); ///< Barrido por interrupción del Timer3 a 100 Hz
 
 // Configuración del LCD
-const int RS = 12, EN = 11, D4 = 5, D5 = 4, D6 = 3, D7 = 2;
-LiquidCrystal lcd(RS, EN, D4, D5, D6, D7);
+LiquidCrystal lcd(Board::LCD_RS, Board::LCD_EN, Board::LCD_D4, Board::LCD_D5, Board::LCD_D6, Board::LCD_D7);
+LcdBuffer pantalla(lcd); ///< Framebuffer del LCD; solo envía los caracteres que cambian
 
 // Configuración del sensor de temperatura y humedad
-const int DHTPIN = 13; ///< Pin del sensor DHT
-#define DHTTYPE DHT22 ///< Tipo de sensor DHT
-DHT dht(DHTPIN, DHTTYPE);
-
-// Pines de los LEDs y otros componentes
-const int LED_GREEN_PIN = 9; ///< Pin del LED verde
-const int LED_RED_PIN = 10; ///< Pin del LED rojo
-const int LED_BLUE_PIN = 8; ///< Pin del LED azul
-const int BUZZER_PIN = 6; ///< Pin del buzzer
-const int PHOTO_RESISTOR_PIN = A0; ///< Pin del fotoresistor
-const int INFRARED_PIN = 14; ///< Pin del sensor infrarrojo
-const int HALL_PIN = 15; ///< Pin del sensor Hall
+DhtSampler dhtSampler(Board::DHT_PIN, Board::DHT_TYPE); ///< Dueño único del sensor DHT (muestreo cada 2 s)
+
+// Pines de los LEDs y otros componentes (ver BoardProfile.h)
+const int BUZZER_PIN = Board::BUZZER; ///< Pin del buzzer
+const int PHOTO_RESISTOR_PIN = Board::PHOTO_RESISTOR; ///< Pin del fotoresistor
+const int INFRARED_PIN = Board::INFRARED; ///< Pin del sensor infrarrojo
+const int HALL_PIN = Board::HALL; ///< Pin del sensor Hall
+AdcSampler lightAdc(PHOTO_RESISTOR_PIN); ///< Fotoresistor sobremuestreado por interrupción
+const unsigned long IR_DEBOUNCE_US = 2000; ///< Ventana antirrebote del sensor infrarrojo
+const unsigned long HALL_DEBOUNCE_US = 5000; ///< Ventana antirrebote del sensor Hall
+int8_t canalInfrarrojo = -1; ///< Canal de eventos del sensor infrarrojo
+int8_t canalHall = -1; ///< Canal de eventos del sensor Hall
+int8_t ledVerde = -1; ///< Canal del LED verde (estado)
+int8_t ledRojo = -1; ///< Canal del LED rojo (alarma)
+int8_t ledAzul = -1; ///< Canal del LED azul (eventos)
+const uint16_t LED_ESTADO_MS = 4000; ///< Respiración del verde mientras se vigila
+const uint16_t LED_EVENTO_MS = 1000; ///< Duración de los avisos de los LEDs
+
+TonePlayer buzzer(BUZZER_PIN); ///< Secuenciador de tonos del buzzer
+
+// Configuración del modo de bajo consumo
+const unsigned long IDLE_WAKE_MS = 100; ///< Tiempo máximo en reposo sin volver a loop()
+PowerManager power(IDLE_WAKE_MS); ///< Reposo entre ticks y contadores de consumo
+
+// Configuración del registro de telemetría
+const unsigned long LOG_PERIOD_MS = 30000; ///< Periodo entre muestras registradas
+TelemetryLog telemetria(EEPROM_LOG_START, EEPROM_LOG_END); ///< Historial en RAM y EEPROM
+bool irVisto = false; ///< Hubo flanco infrarrojo desde la última muestra registrada
+bool hallVisto = false; ///< Hubo flanco Hall desde la última muestra registrada
+
+// Configuración de la telemetría por puerto serie
+const unsigned long STREAM_BAUD = 115200; ///< Velocidad de la UART (~1,6 ms por trama)
+const unsigned long STREAM_PERIOD_MS = 250; ///< Periodo entre tramas de muestra
+
+// Configuración del bus RS-485 entre unidades (Serial1)
+const unsigned long BUS_BAUD = 19200; ///< Velocidad del bus (8E1)
+const uint8_t BUS_DE_PIN = Board::BUS_DE; ///< DE/RE del transceptor RS-485
+const uint8_t BUS_ADDRESS = 1; ///< Dirección Modbus de esta unidad (distinta en cada sala)
+#if defined(BUS_MASTER)
+const uint8_t BUS_NODES = 8; ///< Unidades consultadas: direcciones 1..BUS_NODES
+const unsigned long BUS_POLL_MS = 100; ///< Una consulta cada 100 ms: cada unidad cada 0,8 s
+SensorBus::Node nodosBus[BUS_NODES]; ///< Última copia de los registros de cada unidad
+#endif
+unsigned int irEventos = 0; ///< Flancos infrarrojos desde el arranque
+unsigned int hallEventos = 0; ///< Flancos Hall desde el arranque
+unsigned long irPulsoUs = 0; ///< Ancho del último pulso infrarrojo (nivel alto)
+unsigned long hallPulsoUs = 0; ///< Ancho del último pulso Hall (nivel alto)
 
 /** Variables de estado */
-const String CORRECT_PASSWORD = "0690"; ///< Contraseña correcta
-String inputPassword = ""; ///< Contraseña ingresada
-int attemptCount = 0; ///< Contador de intentos
-const int MAX_ATTEMPTS = 3; ///< Máximo de intentos permitidos
-int currentState = 0; ///< Estado actual del sistema
+const char CORRECT_PASSWORD[PinEntry::LENGTH + 1] PROGMEM = "0690"; ///< Contraseña correcta (en memoria de programa)
+PinEntry inputPassword; ///< Contraseña ingresada (buffer fijo, sin heap)
+const unsigned long LOCKOUT_BASE_MS = 30000; ///< Primer bloqueo; cada bloqueo seguido dura el doble
+Lockout lockout(EEPROM_LOCKOUT_START, LOCKOUT_BASE_MS); ///< Intentos y bloqueo, persistentes en EEPROM
+
+/**
+ * @brief Configuración de fábrica del sitio.
+ *
+ * Se usa hasta que se guarde una configuración desde el menú o si el 
+ * bloque de la EEPROM no es válido.
+ */
+const SettingsData CONFIG_DEFECTO = {
+    1000, ///< Temperatura mínima segura: 10 °C
+    4000, ///< Temperatura máxima segura: 40 °C
+    500, ///< Humedad mínima segura: 5 %
+    6000, ///< Humedad máxima segura: 60 %
+    700, ///< Luz alta: más de 700 lux
+    200, ///< Luz baja: menos de 200 lux
+    4000, ///< Permanencia de la página ambiental (ms)
+    3000, ///< Permanencia de las demás páginas del tablero (ms)
+    3 ///< Intentos de clave antes del bloqueo
+};
+Settings settings(EEPROM_CONFIG_START, CONFIG_DEFECTO); ///< Bloque de configuración en EEPROM
+const SettingsData& cfg = settings.data(); ///< Copia en RAM que leen los manejadores
+static_assert(EEPROM_CONFIG_START + Settings::BLOCK_BYTES <= EEPROM_LOCKOUT_START,
+              "El bloque de configuración debe caber en la zona reservada");
+static_assert(EEPROM_LOCKOUT_START + Lockout::RECORD_BYTES <= EEPROM_LOG_START,
+              "El registro de bloqueo debe caber en la zona reservada");
+
+/**
+ * @brief Estados del sistema.
+ *
+ * El valor de cada estado es su índice en `STATE_TABLE`.
+ */
+enum class State : uint8_t {
+    Login, ///< Esperando la clave
+    Monitoreo, ///< Tablero de páginas
+    Alarma, ///< Alarma crítica de temperatura o humedad
+    Diagnostico, ///< Menú oculto de diagnóstico
+    Config, ///< Menú de configuración
+    Bloqueo, ///< Teclado bloqueado por claves fallidas
+    Count ///< Número de estados
+};
+
+/**
+ * @brief Manejadores y periodo de un estado.
+ *
+ * Cualquiera de las funciones puede ser nula. Un periodo 0 indica que el 
+ * estado no tiene tarea periódica.
+ */
+struct StateHandlers {
+    void (*enter)(); ///< Se llama al entrar al estado
+    void (*tick)(); ///< Se llama cada periodMs mientras dura el estado
+    void (*exit)(); ///< Se llama al salir del estado
+    uint16_t periodMs; ///< Periodo de tick del estado
+};
+
+State currentState = State::Login; ///< Estado actual del sistema
 unsigned long stateChangeTime = 0; ///< Tiempo de cambio de estado
 
+/** Alarma ambiental */
+const int16_t TEMP_HYST_CENTI = 100; ///< Histéresis de temperatura para salir de la alarma (1 °C)
+const int16_t HUM_HYST_CENTI = 200; ///< Histéresis de humedad para salir de la alarma (2 %)
+
+/** Alerta de luz */
+const uint8_t LUZ_HYST_COUNTS = 8; ///< Histéresis de la alerta de luz en cuentas del ADC
+LightThreshold luz; ///< Convierte los umbrales de luz a cuentas del ADC
+
+/** Reglas de alarma (ver AlarmRules.h) */
+enum Canal : uint8_t {
+    CANAL_TEMP, ///< Temperatura filtrada (centésimas de °C)
+    CANAL_HUM, ///< Humedad filtrada (centésimas de %)
+    CANAL_LUZ, ///< Luz filtrada (cuentas del ADC; más cuentas, menos luz)
+    CANAL_IR, ///< Nivel del sensor infrarrojo
+    CANAL_HALL ///< Nivel del sensor Hall
+};
+enum Accion : uint8_t {
+    ACCION_ALARMA, ///< Estado "Alarma" mientras siga activa
+    ACCION_LUZ, ///< Aviso de luz, repetido cada `LUZ_AVISO_MS`
+    ACCION_PROXIMIDAD, ///< monitoreoInfrarrojo()
+    ACCION_MAGNETICO ///< monitoreoHall()
+};
+enum Regla : uint8_t {
+    REGLA_TEMP_ALTA,
+    REGLA_TEMP_BAJA,
+    REGLA_HUM_ALTA,
+    REGLA_HUM_BAJA,
+    REGLA_LUZ_ALTA,
+    REGLA_LUZ_BAJA,
+    REGLA_IR,
+    REGLA_HALL,
+    REGLAS ///< Número de reglas
+};
+const char* const NOMBRES_REGLA[] = {"T alta", "T baja", "H alta", "H baja", "Luz alta", "Luz baja", "IR", "Hall"};
+static_assert(sizeof(NOMBRES_REGLA) / sizeof(NOMBRES_REGLA[0]) == REGLAS, "NOMBRES_REGLA debe tener un nombre por regla");
+const uint8_t PRIORIDAD_CRITICA = 3; ///< Temperatura y humedad
+const uint8_t PRIORIDAD_EVENTO = 2; ///< Infrarrojo y Hall
+const uint8_t PRIORIDAD_LUZ = 1; ///< Luz fuera de rango
+AlarmRule reglas[REGLAS]; ///< Tabla de reglas; los umbrales los fija aplicarConfig()
+bool luzAvisoPendiente = false; ///< La alerta de luz se activó y aún no sonó
+
+/**
+ * @brief Activación de una regla, para la página del registro de alarmas.
+ */
+struct EntradaAlarma {
+    uint8_t regla; ///< Índice en `reglas`
+    unsigned long ms; ///< Instante de la activación
+};
+const uint8_t REGISTRO_ALARMAS = 4; ///< Activaciones que se recuerdan
+EntradaAlarma registroAlarmas[REGISTRO_ALARMAS]; ///< Anillo de las últimas activaciones
+uint8_t registroSiguiente = 0; ///< Próxima posición del anillo
+uint8_t registroCuenta = 0; ///< Activaciones guardadas (hasta `REGISTRO_ALARMAS`)
+unsigned int alarmasActivadas = 0; ///< Activaciones desde el arranque
+
+// Filtros entre la adquisición y los umbrales
+const unsigned long LUZ_SAMPLE_MS = 100; ///< Periodo de muestreo del fotoresistor
+SensorFilter filtroLuz(SensorFilter::MEDIAN_EMA, 2); ///< Sin picos y suavizado (peso 1/4)
+SensorFilter filtroTemp(SensorFilter::MEDIAN); ///< Mediana de 5 muestras del DHT (centésimas de °C)
+SensorFilter filtroHum(SensorFilter::MEDIAN); ///< Mediana de 5 muestras del DHT (centésimas de %)
+
+const char ALARM_ACK_KEY = 'A'; ///< Tecla para silenciar la alarma
+
+// Vigilancia concurrente y rotación de la pantalla
+const unsigned long VIGILANCIA_MS = 100; ///< Periodo de evaluación de todas las alarmas
+const unsigned long LUZ_AVISO_MS = 6000; ///< Repetición del aviso mientras la luz siga fuera de rango
+const unsigned long AVISO_MS = 3000; ///< Tiempo que un aviso de evento tapa la página actual
+unsigned long luzUltimoAviso = 0; ///< Último aviso sonoro por luz fuera de rango
+bool avisoEnPantalla = false; ///< Hay un aviso de evento en el LCD
+unsigned long avisoDesde = 0; ///< Tiempo en que se mostró el aviso
+
+// Tablero del monitoreo (ver Dashboard.h)
+enum Pagina : uint8_t {
+    PAGINA_AMBIENTAL, ///< Temperatura y humedad, con barras dentro del rango seguro
+    PAGINA_LUZ, ///< Lux, nivel y barra de luz
+    PAGINA_PINES, ///< Nivel y flancos de infrarrojo y Hall
+    PAGINA_REGISTRO, ///< Últimas activaciones de reglas
+    PAGINA_ESTADISTICAS, ///< Tiempo encendido y contadores
+    PAGINAS ///< Número de páginas
+};
+const char PAGINA_SIGUIENTE_KEY = 'A'; ///< Página siguiente durante el monitoreo
+const char PAGINA_ANTERIOR_KEY = 'B'; ///< Página anterior durante el monitoreo
+void paginaAmbiental(LcdBuffer& lcd);
+void paginaLuz(LcdBuffer& lcd);
+void paginaPines(LcdBuffer& lcd);
+void paginaRegistro(LcdBuffer& lcd);
+void paginaEstadisticas(LcdBuffer& lcd);
+DashboardPage paginas[PAGINAS] = { ///< Las permanencias las fija aplicarConfig()
+    {paginaAmbiental, 0},
+    {paginaLuz, 0},
+    {paginaPines, 0},
+    {paginaRegistro, 0},
+    {paginaEstadisticas, 0},
+};
+Dashboard tablero(pantalla); ///< Páginas del monitoreo sobre el framebuffer
+
+// Configuración del menú de diagnóstico
+const char DIAG_KEY = 'D'; ///< Abre el menú durante el monitoreo y pasa de página
+const unsigned long DIAG_TIMEOUT_MS = 30000; ///< Sin teclas, el menú vuelve al monitoreo
+const char* const NOMBRES_ESTADO[] = {"Login", "Monitoreo", "Alarma", "Diag", "Config", "Bloqueo"};
+uint8_t diagPagina = 0; ///< Página mostrada del menú de diagnóstico
+unsigned long diagUltimaTecla = 0; ///< Última tecla atendida en el menú
+
+// Configuración del menú de configuración
+const char CONFIG_KEY = 'C'; ///< Abre el menú durante el monitoreo y pasa al campo siguiente
+const char CONFIG_MAS_KEY = 'A'; ///< Aumenta el campo
+const char CONFIG_MENOS_KEY = 'B'; ///< Disminuye el campo
+const char CONFIG_GUARDAR_KEY = 'D'; ///< Guarda y vuelve al monitoreo
+const unsigned long CONFIG_TIMEOUT_MS = 30000; ///< Sin teclas, el menú sale sin guardar
+
+/**
+ * @brief Campo editable del menú de configuración.
+ */
+struct CampoConfig {
+    const char* nombre; ///< Texto de la primera fila
+    uint8_t offset; ///< Posición del campo en `SettingsData`
+    int16_t minimo; ///< Valor mínimo
+    int16_t maximo; ///< Valor máximo
+    int16_t paso; ///< Incremento por tecla
+    bool centesimas; ///< El valor está en centésimas
+};
+const CampoConfig CAMPOS_CONFIG[] = {
+    {"Temp min C", offsetof(SettingsData, tempMinCenti), -4000, 8000, 50, true},
+    {"Temp max C", offsetof(SettingsData, tempMaxCenti), -4000, 8000, 50, true},
+    {"Hum min %", offsetof(SettingsData, humMinCenti), 0, 10000, 100, true},
+    {"Hum max %", offsetof(SettingsData, humMaxCenti), 0, 10000, 100, true},
+    {"Luz alta lux", offsetof(SettingsData, luxAlta), 10, 20000, 10, false},
+    {"Luz baja lux", offsetof(SettingsData, luxBaja), 10, 20000, 10, false},
+    {"Pag ambient ms", offsetof(SettingsData, paginaAmbientalMs), 500, 30000, 500, false},
+    {"Pag resto ms", offsetof(SettingsData, paginaMs), 500, 30000, 500, false},
+    {"Intentos max", offsetof(SettingsData, maxAttempts), 1, SettingsData::MAX_ATTEMPTS, 1, false},
+};
+const uint8_t NUM_CAMPOS_CONFIG = sizeof(CAMPOS_CONFIG) / sizeof(CAMPOS_CONFIG[0]);
+SettingsData configEdicion; ///< Copia que se edita en el menú
+uint8_t configCampo = 0; ///< Campo mostrado
+unsigned long configUltimaTecla = 0; ///< Última tecla atendida en el menú
+bool alarmaSilenciada = false; ///< Indica si el operador silenció la alarma
+
+/** Tareas del planificador */
+int8_t taskTeclado = -1; ///< Lectura del teclado
+int8_t taskEstados = -1; ///< Despacho del estado actual
+int8_t taskVigilancia = -1; ///< Evaluación de las alarmas de todos los canales
+int8_t taskBuzzer = -1; ///< Avance del patrón de tonos
+int8_t taskDht = -1; ///< Muestreo del sensor DHT
+int8_t taskLuz = -1; ///< Muestreo y filtrado del fotoresistor
+int8_t taskPines = -1; ///< Atención de flancos infrarrojo y Hall
+int8_t taskLcd = -1; ///< Envío de cambios al LCD
+int8_t taskTelemetria = -1; ///< Registro periódico de muestras
+int8_t taskEeprom = -1; ///< Copia incremental del registro a la EEPROM
+int8_t taskStream = -1; ///< Envío periódico de tramas por la UART
+int8_t taskBus = -1; ///< Atención del bus RS-485
+
+/** Prototipos */
+void tareaTeclado();
+void procesarTecla(char key);
+void tareaEstados();
+void tareaVigilancia();
+void tareaBuzzer();
+void tareaDht();
+void tareaLuz();
+void tareaPines();
+void tareaLcd();
+void tareaTelemetria();
+void tareaEeprom();
+void tareaStream();
+void enviarTrama(uint8_t type, State previous);
+void tareaBus();
+void llenarRegistros(uint16_t* regs);
+void entrarMonitoreo();
+void monitoreo();
+void monitoreoInfrarrojo();
+void monitoreoHall();
+void entrarAlarma();
+void alarma();
+void salirAlarma();
+void mostrarAlarma();
+void entrarDiagnostico();
+void diagnostico();
+void mostrarDiagnostico();
+void imprimirDuracion(unsigned long us);
+void imprimirEdad(LcdBuffer& lcd, unsigned long ms);
+void entrarConfig();
+void config();
+void mostrarConfig();
+void teclaConfig(char key);
+void aplicarConfig();
+void entrarBloqueo();
+void bloqueo();
+void salirBloqueo();
+void mostrarBloqueo();
+void cambiarEstado(State next);
+bool monitoreando();
+bool vigilando();
+void mostrarAviso(const char* texto);
+void atenderAlarmas();
+void registrarAlarma(uint8_t regla);
+LightThreshold::Level nivelLuz();
+bool paginaLibre();
+uint16_t leerLuzAdc();
+uint16_t luzFiltrada();
+float temperaturaFiltrada();
+float humedadFiltrada();
+void mostrarAsteriscos(uint8_t length);
+void reset();
+void alarmSound();
+void welcomeTone();
+#if defined(BENCHMARK)
+void ejecutarBenchmarks();
+#endif
+
+/**
+ * @brief Tabla de estados, indexada por `State`.
+ *
+ * Se guarda en memoria de programa; el despacho lee el puntero de la 
+ * entrada del estado actual y hace una sola llamada indirecta.
+ */
+constexpr StateHandlers STATE_TABLE[] PROGMEM = {
+    {nullptr, nullptr, nullptr, 0}, ///< Login: solo atiende el teclado
+    {entrarMonitoreo, monitoreo, nullptr, 250}, ///< Monitoreo: rota y redibuja el tablero
+    {entrarAlarma, alarma, salirAlarma, 100}, ///< Alarma
+    {entrarDiagnostico, diagnostico, nullptr, 500}, ///< Diagnostico: refresca los contadores
+    {entrarConfig, config, nullptr, 1000}, ///< Config: solo vigila el tiempo sin teclas
+    {entrarBloqueo, bloqueo, salirBloqueo, 1000}, ///< Bloqueo: cuenta regresiva
+};
+static_assert(sizeof(STATE_TABLE) / sizeof(STATE_TABLE[0]) == (uint8_t)State::Count,
+              "STATE_TABLE debe tener una entrada por estado");
+static_assert(sizeof(NOMBRES_ESTADO) / sizeof(NOMBRES_ESTADO[0]) == (uint8_t)State::Count,
+              "NOMBRES_ESTADO debe tener un nombre por estado");
+static_assert((uint8_t)State::Count <= Diagnostics::MAX_STATES, "Diagnostics no puede contar todos los estados");
+static_assert((uint8_t)State::Count <= (1 << (16 - TelemetryRecord::STATE_SHIFT)),
+              "El estado no cabe en los bits altos de TelemetryRecord::lightFlags");
+
 /**
  * @brief Configuración inicial del sistema.
  * 
@@ -95,58 +437,157 @@ unsigned long stateChangeTime = 0; ///< Tiempo de cambio de estado
  *   magnéticos.
  * - Inicializa el sensor DHT para comenzar a medir temperatura y 
  *   humedad.
- * - Muestra un mensaje inicial en el LCD solicitando al usuario que 
- *   ingrese una clave.
+ * - Carga los caracteres propios del tablero y muestra un mensaje 
+ *   inicial en el LCD solicitando al usuario que ingrese una clave.
+ * - Registra en el planificador las tareas periódicas (teclado y 
+ *   despacho de estados) y las de un solo disparo que reemplazan las 
+ *   esperas con delay().
+ * - Vigila los latidos de las tareas críticas y arranca el watchdog.
  * 
  * Esta configuración es esencial para el correcto funcionamiento del 
  * sistema de monitoreo ambiental y detección de proximidad.
  */
 void setup() {
     lcd.begin(16, 2); ///< Inicializa el LCD con 16 columnas y 2 filas
-    pinMode(LED_GREEN_PIN, OUTPUT); ///< Configura el pin del LED verde como salida
-    pinMode(LED_RED_PIN, OUTPUT); ///< Configura el pin del LED rojo como salida
-    pinMode(LED_BLUE_PIN, OUTPUT); ///< Configura el pin del LED azul como salida
-    pinMode(BUZZER_PIN, OUTPUT); ///< Configura el pin del buzzer como salida
+    keypad.begin(); ///< Configura la matriz y arranca su barrido periódico
+    pantalla.begin(); ///< Sincroniza el framebuffer con el LCD
+    ledVerde = leds.addChannel(Board::LED_GREEN); ///< Configura el pin del LED verde como salida
+    ledRojo = leds.addChannel(Board::LED_RED); ///< Configura el pin del LED rojo como salida
+    ledAzul = leds.addChannel(Board::LED_BLUE); ///< Configura el pin del LED azul como salida
+    leds.begin(); ///< PWM y animaciones desde el Timer4
+    Board::Buzzer::output(); ///< Configura el pin del buzzer como salida
     pinMode(PHOTO_RESISTOR_PIN, INPUT); ///< Configura el pin del fotoresistor como entrada
-    pinMode(INFRARED_PIN, INPUT); ///< Configura el pin del sensor infrarrojo como entrada
-    pinMode(HALL_PIN, INPUT); ///< Configura el pin del sensor Hall como entrada
-    dht.begin(); ///< Inicializa el sensor de temperatura y humedad
-    lcd.print("Ingrese la clave:"); ///< Muestra un mensaje en el LCD
+    lightAdc.begin(); ///< Conversión continua del fotoresistor (sin analogRead())
+    Board::Infrared::input(); ///< Configura el pin del sensor infrarrojo como entrada
+    Board::Hall::input(); ///< Configura el pin del sensor Hall como entrada
+    dhtSampler.begin(); ///< Inicializa el sensor de temperatura y humedad
+    settings.begin(); ///< Carga la configuración del sitio (o la de fábrica)
+    aplicarConfig(); ///< Convierte los umbrales de luz a cuentas del ADC y llena las reglas
+    alarms.begin(reglas, REGLAS); ///< Índice de reglas por canal
+    tablero.begin(paginas, PAGINAS); ///< Caracteres propios en la CGRAM
+    canalInfrarrojo = pinEvents.addChannel(INFRARED_PIN, IR_DEBOUNCE_US); ///< Flancos del sensor infrarrojo
+    canalHall = pinEvents.addChannel(HALL_PIN, HALL_DEBOUNCE_US); ///< Flancos del sensor Hall
+    pinEvents.begin(); ///< Habilita las interrupciones por cambio de pin
+    telemetria.begin(); ///< Continúa el historial guardado en la EEPROM
+    bus.begin(BUS_BAUD, BUS_DE_PIN, BUS_ADDRESS, llenarRegistros); ///< Esclavo Modbus en Serial1
+#if defined(BUS_MASTER)
+    bus.beginMaster(nodosBus, BUS_NODES, BUS_POLL_MS); ///< Además consulta a las demás unidades
+#endif
+    stream.begin(STREAM_BAUD); ///< Abre la UART para las tramas de telemetría
+    diag.begin((uint8_t)currentState); ///< Empieza a contar el tiempo en Login
+    pantalla.print("Ingrese la clave"); ///< Muestra un mensaje en el LCD
+
+    taskTeclado = scheduler.addTask(tareaTeclado, 10, "teclado"); ///< Lee el teclado cada 10 ms
+    taskEstados = scheduler.addTask(tareaEstados, 0, "estados"); ///< Cada estado fija su periodo al entrar
+    taskVigilancia = scheduler.addTask(tareaVigilancia, VIGILANCIA_MS, "vigilancia"); ///< Todas las alarmas, siempre
+    taskBuzzer = scheduler.addTask(tareaBuzzer, 5, "buzzer"); ///< Avanza el patrón de tonos cada 5 ms
+    taskDht = scheduler.addTask(tareaDht, 100, "dht", 8000); ///< El muestreador limita la lectura a su periodo
+    taskLuz = scheduler.addTask(tareaLuz, LUZ_SAMPLE_MS, "luz"); ///< Alimenta el filtro de luz
+    taskPines = scheduler.addTask(tareaPines, 10, "pines"); ///< Vacía la cola de flancos cada 10 ms
+    taskLcd = scheduler.addTask(tareaLcd, 20, "lcd", 2000); ///< Envía los cambios del framebuffer cada 20 ms
+    taskTelemetria = scheduler.addTask(tareaTelemetria, LOG_PERIOD_MS, "telemetria"); ///< Registra una muestra por periodo
+    taskEeprom = scheduler.addTask(tareaEeprom, 5, "eeprom"); ///< Escribe a lo sumo un byte cada 5 ms
+    taskStream = scheduler.addTask(tareaStream, STREAM_PERIOD_MS, "stream"); ///< Envía una muestra por periodo
+    taskBus = scheduler.addTask(tareaBus, 1, "bus", 500); ///< Delimita tramas por silencio (~1,8 ms)
+    if (lockout.begin()) { ///< Un corte de alimentación no levanta el bloqueo
+        cambiarEstado(State::Bloqueo);
+    }
+    watchdog.watch(taskTeclado, 200); ///< Teclado: cada 10 ms
+    watchdog.watch(taskVigilancia, 500); ///< Alarmas: cada 100 ms
+    watchdog.watch(taskDht, 500); ///< Una lectura del DHT que no vuelve
+    watchdog.watch(taskLcd, 200); ///< Pantalla: cada 20 ms
+
+#if defined(BENCHMARK)
+    ejecutarBenchmarks(); ///< Mide manejadores y primitivas antes de operar
+#endif
+    watchdog.begin(); ///< Desde aquí, una tarea colgada reinicia la unidad en menos de un segundo
 }
 
 
 /**
  * @brief Bucle principal del programa.
  * 
- * Esta función se ejecuta continuamente y gestiona la entrada del teclado 
- * así como los estados del sistema. Se encarga de verificar la clave de 
- * acceso, permitir el ingreso de datos y manejar el estado del sistema 
- * según la interacción del usuario.
+ * Esta función se ejecuta continuamente y solo cede el control al 
+ * planificador, que ejecuta las tareas cuyo plazo ya venció. Las esperas 
+ * de los manejadores se programan como tareas diferidas en lugar de 
+ * delay(), de modo que la latencia de entrada queda acotada.
+ * 
+ * La duración de la parte activa (sin el reposo) se acumula en el 
+ * histograma de `diag`.
  * 
- * - **Entrada de Teclado**: Utiliza un keypad para capturar la tecla 
- *   presionada por el usuario. Si se presiona una tecla, se procede a 
- *   verificar su valor.
+ * Si no hay tareas vencidas, el AVR entra en reposo (SLEEP_MODE_IDLE) 
+ * hasta el próximo plazo, una interrupción de entrada o `IDLE_WAKE_MS`, 
+ * lo que ocurra primero.
+ */
+void loop() {
+    diag.loopBegin();
+    scheduler.run(); ///< Ejecuta las tareas vencidas
+    diag.loopEnd(); ///< Histograma de la parte activa de la iteración
+    watchdog.service((uint8_t)currentState); ///< Alimenta el watchdog si todas las tareas vigiladas latieron
+    power.idle(scheduler.msUntilNext(power.wakePeriod())); ///< Duerme hasta el próximo plazo
+}
+
+/**
+ * @brief Tarea de entrada de teclado.
+ * 
+ * Consume todos los eventos que dejó la ISR de barrido desde la última 
+ * ejecución, de modo que las teclas escritas por adelantado no se 
+ * pierden, y procesa cada tecla presionada.
+ */
+void tareaTeclado() {
+    KeyEvent e;
+    while (keypad.pop(e)) { ///< Atiende todas las teclas pendientes
+        if (e.type == KeyEvent::PRESS) {
+            procesarTecla(e.key);
+        }
+    }
+}
+
+/**
+ * @brief Procesa una tecla presionada.
+ * 
+ * Gestiona el ingreso y la verificación de la clave de acceso.
  * 
  * - **Verificación de Clave**: 
  *   - Si se presiona el símbolo `'#'`, se verifica si la longitud de 
  *     la clave ingresada es 4 y si coincide con la clave correcta 
- *     (`CORRECT_PASSWORD`). 
+ *     (`CORRECT_PASSWORD`), comparando siempre todos los dígitos. 
  *       - Si la clave es correcta:
  *         - Limpia la pantalla LCD y muestra un mensaje de bienvenida.
- *         - Enciende el LED verde y emite un tono de bienvenida.
- *         - Cambia el estado del sistema a "Monitoreo Ambiental".
+ *         - Enciende el LED verde 1 segundo y emite un tono de 
+ *           bienvenida; después el verde respira mientras se vigila.
+ *         - Cambia el estado del sistema a "Monitoreo".
  *         - Guarda el tiempo de cambio de estado.
  *       - Si la clave es incorrecta:
- *         - Incrementa el contador de intentos.
+ *         - Incrementa el contador de intentos, guardado en la EEPROM.
  *         - Muestra un mensaje de error y el número de intentos realizados.
- *         - Si se alcanzó el número máximo de intentos (`MAX_ATTEMPTS`):
- *           - Limpia el LCD y muestra un mensaje de bloqueo.
- *           - Activa una alarma y enciende el LED rojo.
- *           - Reinicia el sistema.
+ *         - Si se alcanzó el número máximo de intentos (`cfg.maxAttempts`), 
+ *           pasa a "Bloqueo": `LOCKOUT_BASE_MS` la primera vez y el doble 
+ *           en cada bloqueo seguido, hasta una clave correcta. Mientras 
+ *           tanto se ignora el teclado.
+ * 
+ * - **Reconocimiento de Alarma**: 
+ *   - En el estado de "Alarma", la tecla `ALARM_ACK_KEY` silencia el 
+ *     buzzer y reconoce la alarma; el LED rojo deja de parpadear y sigue 
+ *     encendido hasta que se normalicen las condiciones. La alarma está 
+ *     enclavada: sin el reconocimiento no termina aunque se normalicen.
+ * 
+ * - **Menú de Diagnóstico**: 
+ *   - Durante el monitoreo, `DIAG_KEY` abre el menú; dentro de él pasa 
+ *     de página y `'*'` vuelve al monitoreo.
+ * 
+ * - **Menú de Configuración**: 
+ *   - Durante el monitoreo, `CONFIG_KEY` abre el menú (ver teclaConfig()).
+ * 
+ * - **Tablero**: 
+ *   - Durante el monitoreo, `PAGINA_SIGUIENTE_KEY` y `PAGINA_ANTERIOR_KEY` 
+ *     cambian de página y los dígitos `'1'`… saltan a una página; la 
+ *     rotación automática se pausa `Dashboard::HOLD_MS`. Las demás teclas 
+ *     se ignoran.
  * 
  * - **Limpieza de Entrada**: 
- *   - Si se presiona el símbolo `'*'`, se reinicia la entrada de la clave 
- *     y se muestra un mensaje solicitando la clave nuevamente.
+ *   - En el ingreso de la clave, el símbolo `'*'` reinicia la entrada y 
+ *     se muestra un mensaje solicitando la clave nuevamente.
  * 
  * - **Ingreso de Dígitos**: 
  *   - Si se presiona cualquier otro dígito, se agrega a la entrada de 
@@ -154,335 +595,1228 @@ void setup() {
  *     Se muestra un asterisco en el LCD en lugar del dígito ingresado 
  *     para mantener la privacidad de la clave.
  * 
- * Este bucle permite la interacción continua del usuario con el sistema, 
- * gestionando tanto el ingreso de datos como la respuesta del sistema 
- * a diferentes entradas.
+ * @param key Tecla presionada.
  */
-void loop() {
-    char key = keypad.getKey(); ///< Obtiene la tecla presionada
-
-    if (key) { ///< Si se ha presionado una tecla
-        if (key == '#') { ///< Al presionar '#', verifica la clave
-            if (inputPassword.length() == 4 && inputPassword == CORRECT_PASSWORD) {
-                lcd.clear(); ///< Limpia el LCD
-                lcd.print("Bienvenido"); ///< Muestra mensaje de bienvenida
-                digitalWrite(LED_GREEN_PIN, HIGH); ///< Enciende el LED verde
-                welcomeTone(); ///< Llama a la función de tono de bienvenida
-                delay(1000); ///< Espera 1 segundo
-                digitalWrite(LED_GREEN_PIN, LOW); ///< Apaga el LED verde
-                currentState = 1; ///< Cambia al estado de Monitoreo Ambiental
-                stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
-
-            } else {
-                attemptCount++; ///< Incrementa el contador de intentos
-                lcd.clear(); ///< Limpia el LCD
-                lcd.print("Error intento "); ///< Muestra mensaje de error
-                lcd.print(attemptCount); ///< Muestra el número de intentos
-                inputPassword = ""; ///< Reinicia la entrada
-                if (attemptCount >= MAX_ATTEMPTS) { ///< Si se alcanzó el máximo de intentos
-                    lcd.clear(); ///< Limpia el LCD
-                    lcd.print("Bloqueado"); ///< Muestra mensaje de bloqueo
-                    alarmSound(); ///< Llama a la función de alarma
-                    digitalWrite(LED_RED_PIN, HIGH); ///< Enciende el LED rojo
-                    delay(2000); ///< Espera 2 segundos
-                    digitalWrite(LED_RED_PIN, LOW); ///< Apaga el LED rojo
-                    reset(); ///< Reinicia el sistema
-                }
-            }
-        } else if (key == '*') { ///< Al presionar '*', limpia la entrada
-            inputPassword = ""; ///< Reinicia la entrada
-            lcd.clear(); ///< Limpia el LCD
-            lcd.print("Ingrese la clave:"); ///< Muestra mensaje para ingresar clave
-        } else { ///< Agrega el dígito a la entrada
-            if (inputPassword.length() < 4) { ///< Verifica si la longitud de la entrada es menor a 4
-                inputPassword += key; ///< Agrega el dígito a la entrada
-                lcd.setCursor(0, 1); ///< Establece el cursor en la segunda fila
-                lcd.print(getAsterisks(inputPassword.length())); ///< Muestra '*' en lugar de la clave ingresada
+void procesarTecla(char key) {
+    if (currentState == State::Bloqueo) { ///< Teclado bloqueado
+        return;
+    }
+
+    if (key == ALARM_ACK_KEY && currentState == State::Alarma) { ///< Reconocimiento de la alarma
+        alarmaSilenciada = true; ///< No volver a sonar hasta la próxima alarma
+        buzzer.stop(); ///< Silencia el buzzer
+        alarms.acknowledge(); ///< Libera la alarma enclavada en cuanto se normalice
+        leds.play(ledRojo, LedAnimator::LAYER_ALARM, LedAnimator::SOLID); ///< Rojo fijo: alarma reconocida
+        return;
+    }
+
+    if (currentState == State::Diagnostico) { ///< Menú de diagnóstico
+        diagUltimaTecla = millis();
+        if (key == DIAG_KEY) {
+            diagPagina++; ///< mostrarDiagnostico() vuelve a la primera al pasar la última
+            mostrarDiagnostico();
+        } else if (key == '*') {
+            cambiarEstado(State::Monitoreo); ///< Sale del menú
+        }
+        return;
+    }
+
+    if (currentState == State::Config) { ///< Menú de configuración
+        teclaConfig(key);
+        return;
+    }
+
+    if (key == DIAG_KEY && monitoreando()) { ///< Tecla oculta del menú de diagnóstico
+        cambiarEstado(State::Diagnostico);
+        return;
+    }
+
+    if (key == CONFIG_KEY && monitoreando()) { ///< Menú de configuración
+        cambiarEstado(State::Config);
+        return;
+    }
+
+    if (monitoreando()) { ///< Navegación del tablero
+        if (key == PAGINA_SIGUIENTE_KEY) {
+            tablero.next();
+        } else if (key == PAGINA_ANTERIOR_KEY) {
+            tablero.previous();
+        } else if (key >= '1' && key < '1' + PAGINAS) {
+            tablero.show(key - '1');
+        } else {
+            return; ///< La clave ya se ingresó
+        }
+        avisoEnPantalla = false; ///< La navegación descarta el aviso
+        tablero.draw();
+        return;
+    }
+
+    if (currentState != State::Login) { ///< La clave solo se ingresa en Login
+        return;
+    }
+
+    if (key == '#') { ///< Al presionar '#', verifica la clave
+        if (inputPassword.matches(CORRECT_PASSWORD)) {
+            lockout.succeed(); ///< Borra intentos y nivel de bloqueo
+            cambiarEstado(State::Monitoreo); ///< Pasa al tablero
+            mostrarAviso("Bienvenido"); ///< Muestra mensaje de bienvenida sobre la primera página
+            leds.play(ledVerde, LedAnimator::LAYER_EVENT, LedAnimator::SOLID, 0, LED_EVENTO_MS); ///< Verde fijo 1 segundo
+            leds.play(ledVerde, LedAnimator::LAYER_STATUS, LedAnimator::BREATHE, LED_ESTADO_MS); ///< Luego respira: sistema vigilando
+            welcomeTone(); ///< Llama a la función de tono de bienvenida
+
+        } else {
+            bool bloquear = lockout.fail(cfg.maxAttempts); ///< Cuenta el intento (se guarda en EEPROM)
+            pantalla.clear(); ///< Limpia la pantalla
+            pantalla.print("Error intento "); ///< Muestra mensaje de error
+            pantalla.print(lockout.failures()); ///< Muestra el número de intentos
+            inputPassword.clear(); ///< Reinicia la entrada
+            if (bloquear) { ///< Si se alcanzó el máximo de intentos
+                cambiarEstado(State::Bloqueo);
             }
         }
+    } else if (key == '*') { ///< Al presionar '*', limpia la entrada
+        inputPassword.clear(); ///< Reinicia la entrada
+        pantalla.clear(); ///< Limpia la pantalla
+        pantalla.print("Ingrese la clave"); ///< Muestra mensaje para ingresar clave
+    } else { ///< Agrega el dígito a la entrada
+        if (inputPassword.add(key)) { ///< Agrega el dígito si la entrada tiene menos de 4
+            mostrarAsteriscos(inputPassword.length()); ///< Muestra '*' en lugar de la clave ingresada
+        }
     }
 }
 
+/**
+ * @brief Tarea de despacho de estados.
+ * 
+ * Llama al manejador periódico del estado actual con una sola llamada 
+ * indexada en `STATE_TABLE`. El planificador la ejecuta con el periodo que 
+ * declara cada estado, de modo que entre ticks no se gasta tiempo.
+ */
+void tareaEstados() {
+    void (*tick)() = (void (*)())pgm_read_ptr(&STATE_TABLE[(uint8_t)currentState].tick);
+    if (tick) {
+        tick(); ///< Ejecuta el estado actual
+    }
+}
 
-    // Lógica de cambio de estado
-    switch (currentState) {
-        case 1: ///< Monitoreo Ambiental
-            monitoreoAmbiental(); ///< Llama a la función de monitoreo ambiental
-            break;
-        case 2: ///< Monitor Eventos
-            monitorEventos(); ///< Llama a la función de monitoreo de eventos
-            break;
-        case 3: ///< Alerta
-            alerta(); ///< Llama a la función de alerta
+/**
+ * @brief Cambia el estado del sistema.
+ * 
+ * Ejecuta la salida del estado actual, guarda el tiempo de cambio, 
+ * reprograma la tarea de despacho con el periodo del nuevo estado y 
+ * ejecuta su entrada. Al final envía una trama de transición.
+ * 
+ * @param next Estado al que se pasa.
+ */
+void cambiarEstado(State next) {
+    State previous = currentState;
+    void (*exitFn)() = (void (*)())pgm_read_ptr(&STATE_TABLE[(uint8_t)currentState].exit);
+    if (exitFn) {
+        exitFn(); ///< Salida del estado anterior
+    }
+
+    currentState = next;
+    stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
+    diag.enterState((uint8_t)next); ///< Entradas y tiempo por estado
+
+    uint16_t period = pgm_read_word(&STATE_TABLE[(uint8_t)next].periodMs);
+    if (period) {
+        scheduler.setPeriod(taskEstados, period);
+        scheduler.schedule(taskEstados, period); ///< Primer tick tras un periodo
+    } else {
+        scheduler.cancel(taskEstados); ///< Estado sin tick: la tarea queda dormida
+    }
+
+    void (*enterFn)() = (void (*)())pgm_read_ptr(&STATE_TABLE[(uint8_t)next].enter);
+    if (enterFn) {
+        enterFn(); ///< Entrada al nuevo estado
+    }
+
+    enviarTrama(TelemetryFrame::TRANSITION, previous); ///< Informa el cambio por la UART
+}
+
+/**
+ * @brief Indica si el sistema está en un estado de monitoreo.
+ * 
+ * El tablero solo decide qué página muestra el LCD; todos los canales 
+ * se vigilan igual en cualquiera de ellas.
+ * 
+ * @return true en Monitoreo.
+ */
+bool monitoreando() {
+    return currentState == State::Monitoreo;
+}
+
+/**
+ * @brief Indica si se evalúan las alarmas de los sensores.
+ * 
+ * @return true durante el monitoreo y en los menús; antes 
+ *         del ingreso de la clave y en la alarma crítica no.
+ */
+bool vigilando() {
+    return monitoreando() || currentState == State::Diagnostico || currentState == State::Config;
+}
+
+/**
+ * @brief Tarea de vigilancia de todos los canales.
+ * 
+ * Las reglas se evalúan cuando cambia el valor filtrado de cada canal 
+ * (tareaDht(), tareaLuz() y tareaPines()); aquí se consumen sus eventos y 
+ * se sostienen las reacciones que duran mientras la regla siga activa, 
+ * sin importar qué página muestre el LCD, en orden de prioridad:
+ * 
+ * 1. **Temperatura y humedad** fuera del rango seguro de `cfg`: pasa a 
+ *    "Alarma", que desplaza a todo lo demás. Sin una muestra válida 
+ *    reciente el canal no cambia, de modo que una lectura fallida no la 
+ *    activa.
+ * 2. **Infrarrojo y Hall**: reaccionan en atenderAlarmas() en cuanto 
+ *    tareaPines() informa el flanco.
+ * 3. **Luz** alta o baja: hace parpadear el LED azul y suena la alarma al 
+ *    activarse la regla y luego cada `LUZ_AVISO_MS` mientras dure. Si 
+ *    suena el aviso de un evento de mayor prioridad, se espera a que 
+ *    termine.
+ */
+void tareaVigilancia() {
+    alarms.service(); ///< Reglas con duración mínima
+    atenderAlarmas();
+    if (!vigilando()) {
+        return;
+    }
+
+    if (alarms.actionActive(ACCION_ALARMA)) {
+        cambiarEstado(State::Alarma); ///< Prioridad máxima
+        return;
+    }
+
+    if (!alarms.actionActive(ACCION_LUZ)) {
+        luzAvisoPendiente = false;
+        return;
+    }
+    if ((luzAvisoPendiente || millis() - luzUltimoAviso >= LUZ_AVISO_MS) && !buzzer.isPlaying()) {
+        luzAvisoPendiente = false;
+        luzUltimoAviso = millis();
+        leds.play(ledAzul, LedAnimator::LAYER_EVENT, LedAnimator::BLINK, 250, LED_EVENTO_MS); ///< Parpadeo azul
+        alarmSound(); ///< Llama a la función de alarma
+    }
+}
+
+/**
+ * @brief Muestra el aviso de un evento sobre la página actual.
+ * 
+ * Durante el monitoreo el texto queda `AVISO_MS` en el LCD; el tablero 
+ * no se redibuja mientras tanto, pero la rotación sigue su curso. En los 
+ * menús no se muestra.
+ */
+void mostrarAviso(const char* texto) {
+    if (!monitoreando()) {
+        return;
+    }
+    pantalla.clear(); ///< Limpia la pantalla
+    pantalla.print(texto); ///< Muestra el aviso
+    avisoEnPantalla = true;
+    avisoDesde = millis();
+}
+
+/**
+ * @brief Indica si una página puede dibujarse.
+ * 
+ * @return false mientras un aviso de evento siga vigente.
+ */
+bool paginaLibre() {
+    if (avisoEnPantalla && millis() - avisoDesde < AVISO_MS) {
+        return false;
+    }
+    avisoEnPantalla = false;
+    return true;
+}
+
+/**
+ * @brief Tarea de avance del secuenciador de tonos.
+ */
+void tareaBuzzer() {
+    buzzer.update(); ///< Pasa a la siguiente nota si la actual terminó
+}
+
+/**
+ * @brief Tarea de muestreo del sensor DHT.
+ * 
+ * La transacción con el sensor solo ocurre cuando vence el periodo del 
+ * muestreador; el resto de las veces retorna de inmediato.
+ */
+void tareaDht() {
+    if (dhtSampler.update()) { ///< Actualiza la caché de temperatura y humedad
+        filtroTemp.update((int16_t)(dhtSampler.temperature() * 100)); ///< Solo muestras válidas
+        filtroHum.update((int16_t)(dhtSampler.humidity() * 100));
+        if (filtroTemp.primed()) {
+            alarms.update(CANAL_TEMP, filtroTemp.value());
+            alarms.update(CANAL_HUM, filtroHum.value());
+        }
+    } else if (!dhtSampler.valid()) { ///< Tras una falla prolongada no se mezclan muestras viejas
+        filtroTemp.reset();
+        filtroHum.reset();
+    }
+}
+
+/**
+ * @brief Tarea de muestreo del fotoresistor.
+ * 
+ * Alimenta el filtro de luz a ritmo fijo, de modo que las decisiones de 
+ * alerta usan un valor sin picos aislados aunque el tablero lo muestre 
+ * cada varios segundos.
+ */
+void tareaLuz() {
+    filtroLuz.update(leerLuzAdc());
+    alarms.update(CANAL_LUZ, luzFiltrada()); ///< Solo evalúa si el valor filtrado cambió
+}
+
+/**
+ * @brief Consume los eventos de las reglas de alarma.
+ * 
+ * Toda activación queda en el registro de la página de alarmas. Las de 
+ * infrarrojo y Hall disparan su reacción y la de luz deja pendiente su 
+ * aviso. Antes del ingreso de la clave, durante la 
+ * alarma crítica o si hay activa una regla de mayor prioridad, se 
+ * descartan. La alarma crítica no se atiende aquí sino por su estado en 
+ * tareaVigilancia(), para que también se active si empezó antes del 
+ * ingreso de la clave.
+ */
+void atenderAlarmas() {
+    AlarmEvent e;
+    while (alarms.pop(e)) {
+        if (e.raised) {
+            registrarAlarma(e.rule); ///< Se registra aunque no se reaccione
+        }
+        if (!e.raised || !vigilando() || e.priority < alarms.topPriority()) {
+            continue;
+        }
+        switch (e.action) {
+        case ACCION_PROXIMIDAD:
+            monitoreoInfrarrojo(); ///< Proximidad detectada
             break;
-        case 4: ///< Alarma
-            alarma(); ///< Llama a la función de alarma
+        case ACCION_MAGNETICO:
+            monitoreoHall(); ///< Campo magnético detectado
             break;
-        case 5: ///< Infrarrojo
-            monitoreoInfrarrojo(); ///< Llama a la función de monitoreo infrarrojo
+        case ACCION_LUZ:
+            luzAvisoPendiente = true; ///< Suena en tareaVigilancia() cuando el buzzer esté libre
             break;
-        case 6: ///< Hall
-            monitoreoHall(); ///< Llama a la función de monitoreo Hall
+        default:
             break;
+        }
     }
+}
 
+/**
+ * @brief Guarda una activación en el anillo del registro de alarmas.
+ */
+void registrarAlarma(uint8_t regla) {
+    EntradaAlarma& e = registroAlarmas[registroSiguiente];
+    e.regla = regla;
+    e.ms = millis();
+    registroSiguiente = (registroSiguiente + 1) % REGISTRO_ALARMAS;
+    if (registroCuenta < REGISTRO_ALARMAS) registroCuenta++;
+    alarmasActivadas++;
+}
+
+/**
+ * @brief Nivel de luz según las reglas de luz activas.
+ */
+LightThreshold::Level nivelLuz() {
+    if (alarms.active(REGLA_LUZ_ALTA)) return LightThreshold::ALTA;
+    if (alarms.active(REGLA_LUZ_BAJA)) return LightThreshold::BAJA;
+    return LightThreshold::NORMAL;
+}
 
 /**
- * @brief Monitoreo ambiental de temperatura y humedad.
+ * @brief Tarea de atención de flancos infrarrojo y Hall.
  * 
- * Esta función lee los valores del sensor DHT para obtener la temperatura 
- * y la humedad, y verifica si estos valores se encuentran dentro de un 
- * rango seguro. Si los valores están fuera de los límites establecidos, 
- * se activa el estado de alarma.
+ * Confirma antes el nivel de los canales con un flanco descartado por el 
+ * antirrebote, vacía la cola que llena la interrupción por cambio de pin, 
+ * cuenta los flancos y mide los pulsos, e informa cada nivel a las reglas; la 
+ * reacción la decide atenderAlarmas() en la misma ejecución.
+ */
+void tareaPines() {
+    PinEvent e;
+    pinEvents.settle(); ///< Un pulso más corto que la ventana no deja el canal trabado
+    while (pinEvents.pop(e)) { ///< Atiende todos los flancos pendientes
+        alarms.update(e.channel == canalInfrarrojo ? CANAL_IR : CANAL_HALL, e.level);
+        if (e.level != HIGH) { ///< Flanco de bajada: terminó un pulso
+            if (e.channel == canalInfrarrojo) irPulsoUs = e.durationUs;
+            if (e.channel == canalHall) hallPulsoUs = e.durationUs;
+            continue;
+        }
+        if (e.channel == canalInfrarrojo) { ///< Se registra aunque no se reaccione
+            irVisto = true;
+            irEventos++;
+        }
+        if (e.channel == canalHall) {
+            hallVisto = true;
+            hallEventos++;
+        }
+    }
+    atenderAlarmas();
+}
+
+/**
+ * @brief Tarea de refresco del LCD.
  * 
- * - **Lectura de Sensores**: 
- *   - Se leen los valores de temperatura y humedad desde el sensor DHT.
+ * Compara el framebuffer con lo que ya muestra el LCD y envía solo los 
+ * caracteres distintos; si nada cambió no hay tráfico con la pantalla.
+ */
+void tareaLcd() {
+    pantalla.flush(); ///< Envía las diferencias al LCD
+}
+
+/**
+ * @brief Tarea de registro de telemetría.
  * 
- * - **Verificación de Seguridad**: 
- *   - Si la temperatura está por debajo de 10 °C o por encima de 40 °C, 
- *     o si la humedad está por debajo de 5% o por encima de 60%, 
- *     se cambia el estado del sistema a "Alarma".
+ * Agrega al historial la última muestra del DHT, la lectura cruda del 
+ * fotoresistor, si hubo flancos infrarrojo o Hall desde la muestra 
+ * anterior y el estado actual.
+ */
+void tareaTelemetria() {
+    telemetria.append(dhtSampler.temperature(), dhtSampler.humidity(), dhtSampler.valid(),
+                      leerLuzAdc(), irVisto, hallVisto, (uint8_t)currentState);
+    irVisto = false;
+    hallVisto = false;
+}
+
+/**
+ * @brief Tarea de copia del registro a la EEPROM.
  * 
- * - **Actualización del LCD**: 
- *   - Si el tiempo desde el último cambio de estado es mayor o igual a 4 
- *     segundos, se actualiza la pantalla LCD para mostrar la información 
- *     de monitoreo ambiental (temperatura y humedad).
+ * Avanza un byte de la página pendiente solo si la EEPROM está libre, 
+ * para no esperar los ~3,3 ms de cada escritura.
+ */
+void tareaEeprom() {
+    telemetria.service(); ///< Avanza la copia de la página en curso
+    settings.service(); ///< Avanza el guardado de la configuración
+    lockout.service(); ///< Avanza el guardado de los intentos fallidos
+}
+
+/**
+ * @brief Tarea de envío de telemetría por la UART.
+ */
+void tareaStream() {
+    enviarTrama(TelemetryFrame::SAMPLE, currentState);
+}
+
+/**
+ * @brief Arma y envía una trama con el estado actual de todos los canales.
+ * 
+ * Usa la caché del DHT y el nivel debounced de los sensores infrarrojo y 
+ * Hall, así que no agrega lecturas lentas. Si el buffer de la UART está 
+ * lleno la trama se descarta y queda contada en `stream.dropped()`.
  * 
- * - **Cambio de Estado**: 
- *   - Después de mostrar la información, se cambia el estado a "Monitor 
- *     Eventos".
+ * @param type Tipo de trama (`TelemetryFrame::Type`).
+ * @param previous Estado anterior (igual al actual en las muestras).
  */
-void monitoreoAmbiental() {
-    float h = dht.readHumidity(); ///< Lee la humedad
-    float t = dht.readTemperature(); ///< Lee la temperatura
+void enviarTrama(uint8_t type, State previous) {
+    TelemetryFrame f;
+    bool dhtValido = dhtSampler.valid();
+    f.type = type;
+    f.tempCenti = dhtValido ? (int16_t)(dhtSampler.temperature() * 100) : 0;
+    f.humCenti = dhtValido ? (uint16_t)(dhtSampler.humidity() * 100) : 0;
+    f.light = leerLuzAdc();
+    f.flags = 0;
+    if (pinEvents.level(canalInfrarrojo)) f.flags |= TelemetryFrame::FLAG_IR;
+    if (pinEvents.level(canalHall)) f.flags |= TelemetryFrame::FLAG_HALL;
+    if (dhtValido) f.flags |= TelemetryFrame::FLAG_DHT_VALID;
+    f.state = ((uint8_t)previous << 4) | (uint8_t)currentState;
+    stream.send(f); ///< No bloquea: completa secuencia y tiempo
+}
 
-    // Comprobar condiciones para activar la alarma
-    if (t < 10 || t > 40 || h < 5 || h > 60) {
-        currentState = 4; ///< Cambia al estado de Alarma
-        stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
-        return; ///< Salir de la función para evitar mostrar datos
+/**
+ * @brief Tarea de atención del bus RS-485.
+ * 
+ * Copia lo que recibió la ISR de Serial1 y responde o consulta cuando 
+ * corresponde; nunca espera al bus.
+ */
+void tareaBus() {
+    bus.update();
+}
+
+/**
+ * @brief Llena el mapa de registros del bus desde las cachés.
+ * 
+ * La llama `bus` al responder una consulta. Publica los mismos valores 
+ * filtrados que deciden las alarmas y no lee ningún sensor, de modo que 
+ * una consulta no altera el muestreo ni la máquina de estados.
+ * 
+ * @param regs Registros a llenar (`SensorBus::REG_COUNT`).
+ */
+void llenarRegistros(uint16_t* regs) {
+    bool dhtValido = dhtSampler.valid() && filtroTemp.primed();
+    uint16_t status = 0;
+    if (dhtValido) status |= SensorBus::ST_DHT_VALID;
+    if (pinEvents.level(canalInfrarrojo)) status |= SensorBus::ST_IR;
+    if (pinEvents.level(canalHall)) status |= SensorBus::ST_HALL;
+    if (nivelLuz() != LightThreshold::NORMAL) status |= SensorBus::ST_LIGHT_ALERT;
+    if (currentState == State::Alarma) {
+        status |= SensorBus::ST_ALARM;
+        if (alarmaSilenciada) status |= SensorBus::ST_SILENCED;
     }
 
-    // Evitar que el LCD titile
-    if (millis() - stateChangeTime >= 4000) {
-        lcd.clear(); ///< Limpia el LCD
-        lcd.print("Moni Ambiental"); ///< Muestra mensaje de monitoreo ambiental
-        lcd.setCursor(0, 1); ///< Establece el cursor en la segunda fila
-        lcd.print("T:"); ///< Muestra la etiqueta de temperatura
-        lcd.print(t); ///< Muestra la temperatura
-        lcd.print("C H:"); ///< Muestra la etiqueta de humedad
-        lcd.print(h); ///< Muestra la humedad
+    uint16_t adc = luzFiltrada();
+    unsigned long uptime = millis() / 1000;
+    uint32_t loopMax = diag.stats().loopMaxUs;
+    float mah = power.estimatedMah();
+    regs[SensorBus::REG_STATUS] = status;
+    regs[SensorBus::REG_STATE] = (uint8_t)currentState;
+    regs[SensorBus::REG_TEMP] = dhtValido ? (uint16_t)filtroTemp.value() : 0;
+    regs[SensorBus::REG_HUM] = dhtValido ? (uint16_t)filtroHum.value() : 0;
+    regs[SensorBus::REG_LIGHT] = adc;
+    regs[SensorBus::REG_LUX] = luxFromAdc(adc);
+    regs[SensorBus::REG_UPTIME_HI] = uptime >> 16;
+    regs[SensorBus::REG_UPTIME_LO] = uptime & 0xFFFF;
+    regs[SensorBus::REG_IR_EVENTS] = irEventos;
+    regs[SensorBus::REG_HALL_EVENTS] = hallEventos;
+    regs[SensorBus::REG_DHT_FAILURES] = dhtSampler.failures();
+    regs[SensorBus::REG_LOOP_MAX_US] = loopMax > 0xFFFF ? 0xFFFF : loopMax;
+    regs[SensorBus::REG_IDLE_PCT] = power.idlePercent();
+    regs[SensorBus::REG_MAH] = mah > 65535.0 ? 0xFFFF : (uint16_t)(mah + 0.5);
+}
+
+/**
+ * @brief Entrada al bloqueo por claves fallidas.
+ * 
+ * Suena la alarma y el LED rojo queda fijo. Mientras dura el bloqueo el 
+ * teclado se ignora, pero las tareas de muestreo, registro, bus y 
+ * watchdog siguen trabajando.
+ */
+void entrarBloqueo() {
+    inputPassword.clear();
+    alarmSound(); ///< Llama a la función de alarma
+    leds.play(ledRojo, LedAnimator::LAYER_ALARM, LedAnimator::SOLID); ///< Rojo fijo durante el bloqueo
+    mostrarBloqueo();
+}
 
-        currentState = 2; ///< Cambia al estado de Monitor Eventos
-        stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
+/**
+ * @brief Tick del bloqueo: cuenta regresiva y vuelta al ingreso de la clave.
+ */
+void bloqueo() {
+    if (lockout.locked()) {
+        mostrarBloqueo();
+        return;
     }
+    cambiarEstado(State::Login);
 }
 
 /**
- * @brief Monitoreo de eventos de luz.
+ * @brief Salida del bloqueo.
+ */
+void salirBloqueo() {
+    leds.stop(ledRojo, LedAnimator::LAYER_ALARM); ///< Apaga el LED rojo
+    reset(); ///< Vuelve a pedir la clave
+}
+
+/**
+ * @brief Muestra el nivel de bloqueo y el tiempo que falta.
+ */
+void mostrarBloqueo() {
+    pantalla.clear();
+    pantalla.print("Bloqueado x"); ///< Muestra mensaje de bloqueo
+    pantalla.print(lockout.level());
+    pantalla.setCursor(0, 1);
+    pantalla.print("Espere ");
+    pantalla.print((lockout.remainingMs() + 999) / 1000);
+    pantalla.print("s");
+}
+
+
+/**
+ * @brief Entrada al monitoreo: el tablero empieza por la página ambiental.
+ */
+void entrarMonitoreo() {
+    tablero.start();
+    tablero.draw();
+}
+
+/**
+ * @brief Tick del estado "Monitoreo".
  * 
- * Esta función lee el valor del fotoresistor y calcula la cantidad de luz 
- * en lux. Dependiendo del valor medido, puede cambiar el estado del sistema 
- * a "Alerta" o volver al estado de "Monitoreo Ambiental".
+ * Rota el tablero según la permanencia de cada página 
+ * (`cfg.paginaAmbientalMs` la ambiental, `cfg.paginaMs` las demás) y 
+ * redibuja la página actual salvo que un aviso la tape. Solo dibuja: las 
+ * alarmas las evalúa tareaVigilancia() en cualquier página, y las páginas 
+ * leen filtros y contadores, nunca un sensor. El framebuffer solo envía 
+ * los caracteres que cambian, así que redibujar en cada tick no hace 
+ * titilar el LCD.
+ */
+void monitoreo() {
+    tablero.update();
+    if (paginaLibre()) {
+        tablero.draw();
+    }
+}
+
+/**
+ * @brief Página de temperatura y humedad.
  * 
- * - **Lectura del Fotoresistor**: 
- *   - Se obtiene el valor analógico del fotoresistor y se convierte a 
- *     voltaje.
+ * Valores filtrados (mediana de las 5 últimas muestras válidas) y, en la 
+ * segunda fila, dónde cae cada uno dentro de su rango seguro de `cfg`. 
+ * Sin una muestra válida reciente lo indica.
+ */
+void paginaAmbiental(LcdBuffer& lcd) {
+    if (!dhtSampler.valid() || !filtroTemp.primed()) {
+        lcd.print("Sensor sin datos"); ///< No hay muestra válida reciente
+        return;
+    }
+    lcd.print("T ");
+    lcd.print(temperaturaFiltrada(), 1);
+    lcd.write(Dashboard::GLYPH_DEGREE);
+    lcd.print("C H ");
+    lcd.print(humedadFiltrada(), 0);
+    lcd.print("%");
+    lcd.setCursor(0, 1);
+    lcd.print("T");
+    Dashboard::bar(lcd, 1, 1, 7, filtroTemp.value(), cfg.tempMinCenti, cfg.tempMaxCenti);
+    lcd.print("H");
+    Dashboard::bar(lcd, 9, 1, 7, filtroHum.value(), cfg.humMinCenti, cfg.humMaxCenti);
+}
+
+/**
+ * @brief Página de luz.
  * 
- * - **Cálculo de Lux**: 
- *   - Se calcula la resistencia y se convierte a lux utilizando la 
- *     fórmula adecuada.
+ * Lectura filtrada del fotoresistor en lux (solo aquí se convierte), el 
+ * nivel si una regla de luz está activa y una barra con las cuentas del 
+ * ADC invertidas: más luz, barra más larga.
+ */
+void paginaLuz(LcdBuffer& lcd) {
+    uint16_t adc = luzFiltrada();
+    LightThreshold::Level nivel = nivelLuz(); ///< Estado de las reglas de luz
+    lcd.print("Luz ");
+    lcd.print(luxFromAdc(adc), 0);
+    lcd.write(Dashboard::GLYPH_LUX);
+    if (nivel == LightThreshold::ALTA) {
+        lcd.print(" ALTA");
+    } else if (nivel == LightThreshold::BAJA) {
+        lcd.print(" BAJA");
+    }
+    Dashboard::bar(lcd, 0, 1, LcdBuffer::COLS, 1023 - adc, 0, 1023);
+}
+
+/**
+ * @brief Página de los sensores infrarrojo y Hall.
  * 
- * - **Actualización del LCD**: 
- *   - Si ha pasado más de 3 segundos desde el último cambio de estado, 
- *     se actualiza la pantalla LCD para mostrar el valor de luz medido.
+ * Nivel sin rebote que guarda `pinEvents` y flancos desde el arranque.
+ */
+void paginaPines(LcdBuffer& lcd) {
+    lcd.print("IR   ");
+    lcd.print(pinEvents.level(canalInfrarrojo) ? "ACT" : "---");
+    lcd.print(" n");
+    lcd.print(irEventos);
+    lcd.setCursor(0, 1);
+    lcd.print("Hall ");
+    lcd.print(pinEvents.level(canalHall) ? "ACT" : "---");
+    lcd.print(" n");
+    lcd.print(hallEventos);
+}
+
+/**
+ * @brief Página del registro de alarmas: las dos activaciones más recientes.
+ */
+void paginaRegistro(LcdBuffer& lcd) {
+    if (!registroCuenta) {
+        lcd.print("Sin alarmas");
+        return;
+    }
+    for (uint8_t i = 0; i < 2 && i < registroCuenta; i++) {
+        const EntradaAlarma& e = registroAlarmas[(registroSiguiente + REGISTRO_ALARMAS - 1 - i) % REGISTRO_ALARMAS];
+        lcd.setCursor(0, i);
+        lcd.write(Dashboard::GLYPH_BELL);
+        lcd.print(NOMBRES_REGLA[e.regla]);
+        lcd.print(" ");
+        imprimirEdad(lcd, millis() - e.ms);
+    }
+}
+
+/**
+ * @brief Página de estadísticas: tiempo encendido, alarmas críticas y 
+ * activaciones de reglas.
+ */
+void paginaEstadisticas(LcdBuffer& lcd) {
+    unsigned long minutos = millis() / 60000;
+    lcd.print("Activo ");
+    lcd.print(minutos / 60);
+    lcd.print("h");
+    if (minutos % 60 < 10) lcd.print("0");
+    lcd.print(minutos % 60);
+    lcd.print("m");
+    lcd.setCursor(0, 1);
+    lcd.print("Alarm ");
+    lcd.print((unsigned int)diag.stats().stateEntries[(uint8_t)State::Alarma]);
+    lcd.print(" Reg ");
+    lcd.print(alarmasActivadas);
+}
+
+/**
+ * @brief Imprime cuánto pasó: segundos, minutos u horas.
+ */
+void imprimirEdad(LcdBuffer& lcd, unsigned long ms) {
+    unsigned long s = ms / 1000;
+    if (s < 60) {
+        lcd.print(s);
+        lcd.print("s");
+    } else if (s < 3600) {
+        lcd.print(s / 60);
+        lcd.print("m");
+    } else {
+        lcd.print(s / 3600);
+        lcd.print("h");
+    }
+}
+
+/**
+ * @brief Reacción del sensor infrarrojo.
  * 
- * - **Cambio de Estado**: 
- *   - Si el valor de lux es mayor a 700 o menor a 200, se cambia el estado 
- *     a "Alerta". Si no, se regresa al estado de "Monitoreo Ambiental".
+ * Se llama desde tareaPines() ante un flanco de subida capturado por 
+ * interrupción. Activa la alarma y el LED azul porque se detectó 
+ * proximidad.
  */
-void monitorEventos() {
-    int analogValue = analogRead(PHOTO_RESISTOR_PIN); ///< Lee el valor analógico del fotoresistor
-    float voltage = analogValue / 1024. * 5; ///< Calcula el voltaje
-    float resistance = 2000 * voltage / (1 - voltage / 5); ///< Calcula la resistencia
-    float lux = pow(RL10 * 1e3 * pow(10, GAMMA) / resistance, (1 / GAMMA)); ///< Calcula el lux
+void monitoreoInfrarrojo() {
+    mostrarAviso("Proximidad IR"); ///< Muestra mensaje de activación
+    leds.play(ledAzul, LedAnimator::LAYER_EVENT, LedAnimator::SOLID, 0, LED_EVENTO_MS); ///< Azul fijo 1 segundo
+    alarmSound(); ///< Llama a la función de alarma
+}
 
-    // Evitar que el LCD titile
-    if (millis() - stateChangeTime >= 3000) {
-        lcd.clear(); ///< Limpia el LCD
-        lcd.print("Moni Eventos"); ///< Muestra mensaje de monitoreo de eventos
-        lcd.setCursor(0, 1); ///< Establece el cursor en la segunda fila
-        lcd.print("Luz : "); ///< Muestra la etiqueta de luz
-        lcd.print(lux); ///< Muestra el valor de lux
+/**
+ * @brief Reacción del sensor Hall.
+ * 
+ * Se llama desde tareaPines() ante un flanco de subida capturado por 
+ * interrupción. Activa la alarma y el LED azul porque se detectó un 
+ * campo electromagnético.
+ */
+void monitoreoHall() {
+    mostrarAviso("Hall Activo"); ///< Muestra mensaje de activación
+    leds.play(ledAzul, LedAnimator::LAYER_EVENT, LedAnimator::PULSE, 200, LED_EVENTO_MS); ///< Destellos azules
+    alarmSound(); ///< Llama a la función de alarma
+}
+
+/**
+ * @brief Entrada al estado de alarma.
+ * 
+ * Enciende el LED rojo, inicia el sonido de alarma y muestra el mensaje 
+ * de alerta crítica.
+ */
+void entrarAlarma() {
+    alarmaSilenciada = false;
+    leds.play(ledRojo, LedAnimator::LAYER_ALARM, LedAnimator::BLINK, 500); ///< Rojo intermitente: tapa el verde de estado
+    alarmSound(); ///< Llama a la función de alarma
+    mostrarAlarma();
+}
+
+/**
+ * @brief Manejo de la alarma.
+ * 
+ * Tick del estado de alarma: retorna de inmediato, de modo que el teclado 
+ * y los demás canales siguen atendidos.
+ * 
+ * - **Pantalla**: la regla que causó la alarma y el valor filtrado actual.
+ * 
+ * - **Sonido**: mientras no se silencie con `ALARM_ACK_KEY`, el patrón de 
+ *   alarma se repite al terminar.
+ * - **Salida**: cuando se liberan todas las reglas de temperatura y 
+ *   humedad, es decir, cuando ambas vuelven al rango seguro con un margen 
+ *   de histéresis (`TEMP_HYST_CENTI`, `HUM_HYST_CENTI`) y la alarma fue 
+ *   reconocida. Sin una muestra válida las reglas no cambian y la alarma 
+ *   se mantiene.
+ */
+void alarma() {
+    if (!alarmaSilenciada && !buzzer.isPlaying()) { ///< Mantener la alarma sonando
+        alarmSound();
+    }
+
+    if (!alarms.actionActive(ACCION_ALARMA)) {
+        cambiarEstado(State::Monitoreo); ///< Regresar al tablero
+        return;
+    }
+    mostrarAlarma(); ///< Valor al día
+}
 
-        // Condición para pasar al estado de Alerta
-        if (lux > 700 || lux < 200) {
-            currentState = 3; ///< Cambia al estado de Alerta
-            stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
+/**
+ * @brief Muestra la alerta crítica: la primera regla activa de temperatura 
+ * o humedad y el valor filtrado de su canal.
+ */
+void mostrarAlarma() {
+    pantalla.clear(); ///< Limpia la pantalla
+    pantalla.print("ALERTA CRITICA!"); ///< Muestra mensaje de alerta crítica
+    pantalla.setCursor(0, 1); ///< Establece el cursor en la segunda fila
+    for (uint8_t r = REGLA_TEMP_ALTA; r <= REGLA_HUM_BAJA; r++) {
+        if (!alarms.active(r)) continue;
+        pantalla.print(NOMBRES_REGLA[r]);
+        pantalla.print(" ");
+        if (reglas[r].channel == CANAL_TEMP) {
+            pantalla.print(temperaturaFiltrada(), 1);
+            pantalla.write(Dashboard::GLYPH_DEGREE);
+            pantalla.print("C");
         } else {
-            currentState = 1; ///< Vuelve al estado de Monitoreo Ambiental
-            stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
+            pantalla.print(humedadFiltrada(), 0);
+            pantalla.print("%");
         }
+        return;
     }
+    pantalla.print("Fuera de rango"); ///< Ninguna activa: la salida llega en el próximo tick
 }
 
+/**
+ * @brief Salida del estado de alarma.
+ * 
+ * Apaga el LED rojo y detiene el buzzer.
+ */
+void salirAlarma() {
+    leds.stop(ledRojo, LedAnimator::LAYER_ALARM); ///< Apaga el LED rojo; vuelve el verde de estado
+    buzzer.stop(); ///< Detener el sonido del buzzer
+}
 
 /**
- * @brief Monitoreo del sensor infrarrojo.
+ * @brief Entrada al menú de diagnóstico.
+ */
+void entrarDiagnostico() {
+    diagPagina = 0;
+    diagUltimaTecla = millis();
+    mostrarDiagnostico();
+}
+
+/**
+ * @brief Tick del menú de diagnóstico.
  * 
- * Activa la alarma y el LED azul si se detecta proximidad.
+ * Redibuja la página actual con los contadores al día (el framebuffer 
+ * solo envía lo que cambió) y vuelve al monitoreo si nadie usa el menú 
+ * durante `DIAG_TIMEOUT_MS`. Mientras el menú está abierto no se 
+ * reacciona a los sensores.
  */
-void monitoreoInfrarrojo() {
-    if (digitalRead(INFRARED_PIN) == HIGH) { ///< Si se detecta proximidad
-        lcd.clear(); ///< Limpia el LCD
-        lcd.print("Infrarrojo Activo"); ///< Muestra mensaje de activación
-        digitalWrite(LED_BLUE_PIN, HIGH); ///< Enciende el LED azul
-        alarmSound(); ///< Llama a la función de alarma
-        delay(1000); ///< Espera 1 segundo
-        digitalWrite(LED_BLUE_PIN, LOW); ///< Apaga el LED azul
-        currentState = 2; ///< Regresar al estado de Monitor Eventos
-        stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
+void diagnostico() {
+    if (millis() - diagUltimaTecla >= DIAG_TIMEOUT_MS) {
+        cambiarEstado(State::Monitoreo); ///< Nadie usa el menú
+        return;
     }
+    mostrarDiagnostico();
 }
 
 /**
- * @brief Monitoreo del sensor Hall.
+ * @brief Imprime una duración en µs, o en ms si no cabe en la fila.
+ */
+void imprimirDuracion(unsigned long us) {
+    if (us < 10000) {
+        pantalla.print(us);
+        pantalla.print("us");
+    } else {
+        pantalla.print(us / 1000);
+        pantalla.print("ms");
+    }
+}
+
+/**
+ * @brief Muestra la página `diagPagina` del menú de diagnóstico.
+ * 
+ * Páginas, en orden:
+ * - Iteración más lenta del bucle y cantidad de iteraciones.
+ * - Histograma: dos intervalos no vacíos por página, como "<2^(b+1) µs".
+ * - Por estado: entradas y tiempo acumulado.
+ * - Lecturas fallidas del DHT y tramas descartadas.
+ * - Ancho del último pulso infrarrojo y Hall.
+ * - Último reinicio por watchdog: tarea culpable y estado.
+ * - Reposo: porcentaje y tiempo acumulado, y carga estimada en mAh.
  * 
- * Activa la alarma y el LED azul si se detecta un campo electromagnético.
+ * Si `diagPagina` pasa la última página vuelve a la primera.
  */
-void monitoreoHall() {
-    if (digitalRead(HALL_PIN) == HIGH) { ///< Si se detecta campo electromagnético
-        lcd.clear(); ///< Limpia el LCD
-        lcd.print("Hall Activo"); ///< Muestra mensaje de activación
-        digitalWrite(LED_BLUE_PIN, HIGH); ///< Enciende el LED azul
-        alarmSound(); ///< Llama a la función de alarma
-        delay(1000); ///< Espera 1 segundo
-        digitalWrite(LED_BLUE_PIN, LOW); ///< Apaga el LED azul
-        currentState = 2; ///< Regresar al estado de Monitor Eventos
-        stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
-    }
-}
-
-/**
- * @brief Manejo de alertas por condiciones de luz.
- * 
- * Cambia el estado a alerta si se detectan condiciones anormales de luz.
- */
-void alerta() {
-    int analogValue = analogRead(PHOTO_RESISTOR_PIN); ///< Lee el valor analógico del fotoresistor
-    float voltage = analogValue / 1024. * 5; ///< Calcula el voltaje
-    float resistance = 2000 * voltage / (1 - voltage / 5); ///< Calcula la resistencia
-    float lux = pow(RL10 * 1e3 * pow(10, GAMMA) / resistance, (1 / GAMMA)); ///< Calcula el lux
-    
-    // Evitar que el LCD titile
-    if (millis() - stateChangeTime >= 3000) {
-        lcd.clear(); ///< Limpia el LCD
-        lcd.print("Alerta!"); ///< Muestra mensaje de alerta
-        lcd.setCursor(0, 1); ///< Establece el cursor en la segunda fila
-        if (lux > 700) { ///< Si la luz es alta
-            lcd.print("Luz: Alta"); ///< Muestra mensaje de luz alta
-            digitalWrite(LED_BLUE_PIN, HIGH); ///< Enciende el LED azul
-            alarmSound(); ///< Llama a la función de alarma
-            delay(1000); ///< Espera 1 segundo
-            digitalWrite(LED_BLUE_PIN, LOW); ///< Apaga el LED azul
-        } else if (lux < 200) { ///< Si la luz es baja
-            lcd.print("Luz: Baja"); ///< Muestra mensaje de luz baja
-            digitalWrite(LED_BLUE_PIN, HIGH); ///< Enciende el LED azul
-            alarmSound(); ///< Llama a la función de alarma
-            delay(1000); ///< Espera 1 segundo
-            digitalWrite(LED_BLUE_PIN, LOW); ///< Apaga el LED azul
+void mostrarDiagnostico() {
+    const Diagnostics::Stats& s = diag.stats();
+    pantalla.clear();
+    uint8_t p = diagPagina;
+
+    if (p == 0) {
+        pantalla.print("Lazo max ");
+        pantalla.print(s.loopMaxUs);
+        pantalla.print("us");
+        pantalla.setCursor(0, 1);
+        pantalla.print("Iter ");
+        pantalla.print(s.loops);
+        return;
+    }
+    p--;
+
+    uint8_t usados = 0; ///< Intervalos no vacíos recorridos
+    for (uint8_t b = 0; b < Diagnostics::LOOP_BUCKETS; b++) {
+        if (!s.loopHist[b]) continue;
+        if (usados / 2 == p) {
+            pantalla.setCursor(0, usados % 2);
+            pantalla.print(b == Diagnostics::LOOP_BUCKETS - 1 ? ">=" : "<");
+            pantalla.print(1UL << (b == Diagnostics::LOOP_BUCKETS - 1 ? b : b + 1));
+            pantalla.print("us ");
+            pantalla.print((unsigned int)s.loopHist[b]);
         }
-        currentState = 2; ///< Vuelve al estado de Monitor Eventos
-        stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
+        usados++;
+    }
+    uint8_t paginasHist = (usados + 1) / 2;
+    if (p < paginasHist) {
+        return;
     }
+    p -= paginasHist;
+
+    if (p < (uint8_t)State::Count) {
+        pantalla.print(NOMBRES_ESTADO[p]);
+        pantalla.print(" x");
+        pantalla.print((unsigned int)s.stateEntries[p]);
+        pantalla.setCursor(0, 1);
+        pantalla.print("Tiempo ");
+        pantalla.print(s.stateDwellMs[p] / 1000);
+        pantalla.print("s");
+        return;
+    }
+    p -= (uint8_t)State::Count;
+
+    if (p == 0) {
+        pantalla.print("Fallas DHT ");
+        pantalla.print((unsigned int)s.dhtFailures);
+        pantalla.setCursor(0, 1);
+        pantalla.print("Tramas perd ");
+        pantalla.print((unsigned int)stream.dropped());
+        return;
+    }
+    p--;
+
+    if (p == 0) {
+        pantalla.print("Pulso IR ");
+        imprimirDuracion(irPulsoUs);
+        pantalla.setCursor(0, 1);
+        pantalla.print("Pulso Hall ");
+        imprimirDuracion(hallPulsoUs);
+        return;
+    }
+    p--;
+
+    if (p == 0) {
+        const Watchdog::ResetInfo& r = watchdog.lastReset();
+        pantalla.print("WDT x");
+        pantalla.print(r.count);
+        pantalla.print(" atr ");
+        pantalla.print(watchdog.starvations());
+        pantalla.setCursor(0, 1);
+        if (!watchdog.hadReset()) {
+            pantalla.print("Sin reinicios");
+        } else {
+            pantalla.print(r.task >= 0 ? scheduler.task(r.task).name : "?");
+            pantalla.print(" ");
+            pantalla.print(r.state < (uint8_t)State::Count ? NOMBRES_ESTADO[r.state] : "?");
+        }
+        return;
+    }
+    p--;
+
+    if (p == 0) {
+        pantalla.print("Reposo ");
+        pantalla.print(power.idlePercent());
+        pantalla.print("% ");
+        pantalla.print(power.idleMs() / 1000);
+        pantalla.print("s");
+        pantalla.setCursor(0, 1);
+        pantalla.print("Carga ");
+        pantalla.print(power.estimatedMah(), 1);
+        pantalla.print("mAh");
+        return;
+    }
+    p--;
+
+    if (p == 0) {
+        pantalla.print("Bus resp ");
+        pantalla.print(bus.served());
+        pantalla.setCursor(0, 1);
+        pantalla.print("Bus CRC mal ");
+        pantalla.print(bus.crcErrors());
+        return;
+    }
+#if defined(BUS_MASTER)
+    p--;
+
+    if (p == 0) {
+        uint8_t enLinea = 0, enAlarma = 0;
+        for (uint8_t i = 0; i < bus.nodeCount(); i++) {
+            const SensorBus::Node& n = bus.node(i);
+            if (!n.online) continue;
+            enLinea++;
+            if (n.regs[SensorBus::REG_STATUS] & SensorBus::ST_ALARM) enAlarma++;
+        }
+        pantalla.print("Nodos ");
+        pantalla.print(enLinea);
+        pantalla.print("/");
+        pantalla.print(bus.nodeCount());
+        pantalla.setCursor(0, 1);
+        pantalla.print("En alarma ");
+        pantalla.print(enAlarma);
+        return;
+    }
+#endif
+
+    diagPagina = 0; ///< Pasó la última página
+    mostrarDiagnostico();
 }
 
 /**
- * @brief Manejo de la alarma.
+ * @brief Entrada al menú de configuración.
  * 
- * Activa la alarma y mantiene el estado de alarma hasta que se resuelva.
+ * Copia la configuración actual para editarla; nada cambia hasta guardar.
  */
-void alarma() {
-    digitalWrite(LED_RED_PIN, HIGH); ///< Enciende el LED rojo
-    alarmSound(); ///< Llama a la función de alarma
+void entrarConfig() {
+    configEdicion = cfg;
+    configCampo = 0;
+    configUltimaTecla = millis();
+    mostrarConfig();
+}
+
+/**
+ * @brief Tick del menú de configuración.
+ * 
+ * Sin teclas durante `CONFIG_TIMEOUT_MS` sale sin guardar.
+ */
+void config() {
+    if (millis() - configUltimaTecla >= CONFIG_TIMEOUT_MS) {
+        cambiarEstado(State::Monitoreo); ///< Nadie usa el menú
+    }
+}
 
-    lcd.clear(); ///< Limpia el LCD
-    lcd.print("ALERTA CRITICA!"); ///< Muestra mensaje de alerta crítica
-    lcd.setCursor(0, 1); ///< Establece el cursor en la segunda fila
-    lcd.print("T o H fuera de"); ///< Muestra mensaje de condiciones fuera de rango
-    lcd.setCursor(0, 2); ///< Establece el cursor en la tercera fila
-    lcd.print("rango seguro!");
-
-    // Mantener el estado de alarma hasta que se resuelva
-    while (true) {
-        float h = dht.readHumidity(); ///< Lee la humedad
-        float t = dht.readTemperature(); ///< Lee la temperatura
-
-        // Verificar si las condiciones de alarma aún se cumplen
-        if (t >= 10 && t <= 40 && h >= 5 && h <= 60) {
-            digitalWrite(LED_RED_PIN, LOW); ///< Apaga el LED rojo
-            noTone(BUZZER_PIN); ///< Detener el sonido del buzzer
-            currentState = 1; ///< Regresar al estado de Monitoreo Ambiental
-            stateChangeTime = millis(); ///< Guarda el tiempo de cambio de estado
-            break; ///< Salir del bucle
+/**
+ * @brief Muestra el campo `configCampo` con el valor en edición.
+ */
+void mostrarConfig() {
+    const CampoConfig& c = CAMPOS_CONFIG[configCampo];
+    int16_t v = *(const int16_t*)((const uint8_t*)&configEdicion + c.offset);
+    pantalla.clear();
+    pantalla.print(c.nombre);
+    pantalla.setCursor(0, 1);
+    if (c.centesimas) {
+        pantalla.print(v / 100.0);
+    } else {
+        pantalla.print(v);
+    }
+}
+
+/**
+ * @brief Procesa una tecla en el menú de configuración.
+ * 
+ * - `CONFIG_MAS_KEY` / `CONFIG_MENOS_KEY`: cambian el campo en un paso, 
+ *   dentro de su rango.
+ * - `CONFIG_KEY`: pasa al campo siguiente.
+ * - `CONFIG_GUARDAR_KEY`: si los valores son coherentes los aplica, los 
+ *   guarda en la EEPROM y vuelve al monitoreo; si no, lo indica y sigue 
+ *   en el menú.
+ * - `'*'`: vuelve al monitoreo sin guardar.
+ */
+void teclaConfig(char key) {
+    configUltimaTecla = millis();
+    const CampoConfig& c = CAMPOS_CONFIG[configCampo];
+    int16_t* v = (int16_t*)((uint8_t*)&configEdicion + c.offset);
+
+    if (key == CONFIG_MAS_KEY) {
+        *v = *v <= c.maximo - c.paso ? *v + c.paso : c.maximo;
+    } else if (key == CONFIG_MENOS_KEY) {
+        *v = *v >= c.minimo + c.paso ? *v - c.paso : c.minimo;
+    } else if (key == CONFIG_KEY) {
+        configCampo = configCampo + 1 < NUM_CAMPOS_CONFIG ? configCampo + 1 : 0;
+    } else if (key == CONFIG_GUARDAR_KEY) {
+        if (!settings.save(configEdicion)) {
+            pantalla.setCursor(0, 1);
+            pantalla.print("Config invalida ");
+            return;
         }
+        aplicarConfig();
+        cambiarEstado(State::Monitoreo);
+        mostrarAviso("Config guardada");
+        return;
+    } else if (key == '*') {
+        cambiarEstado(State::Monitoreo); ///< Sale sin guardar
+        return;
+    } else {
+        return;
     }
+    mostrarConfig();
 }
 
 /**
- * @brief Genera una cadena de asteriscos.
+ * @brief Aplica la configuración en RAM a los módulos que la precalculan.
  * 
- * @param length Longitud de la cadena de asteriscos.
- * @return String Cadena de asteriscos.
+ * Los umbrales de luz se convierten a cuentas del ADC una sola vez aquí 
+ * y, con los de temperatura y humedad, pasan a la tabla de reglas, que 
+ * se reevalúa con los últimos valores; las permanencias pasan a la tabla 
+ * de páginas del tablero. El resto de los campos se leen directamente de 
+ * `cfg`.
  */
-String getAsterisks(int length) {
-    String asterisks = ""; ///< Inicializa la cadena de asteriscos
-    for (int i = 0; i < length; i++) { ///< Itera según la longitud
-        asterisks += '*'; ///< Agrega un asterisco por cada dígito ingresado
+void aplicarConfig() {
+    luz.begin(cfg.luxAlta, cfg.luxBaja);
+    const uint8_t latch = AlarmRules::LATCH;
+    reglas[REGLA_TEMP_ALTA] = {CANAL_TEMP, AlarmRules::ABOVE, cfg.tempMaxCenti, TEMP_HYST_CENTI, 0, PRIORIDAD_CRITICA, ACCION_ALARMA, latch};
+    reglas[REGLA_TEMP_BAJA] = {CANAL_TEMP, AlarmRules::BELOW, cfg.tempMinCenti, TEMP_HYST_CENTI, 0, PRIORIDAD_CRITICA, ACCION_ALARMA, latch};
+    reglas[REGLA_HUM_ALTA] = {CANAL_HUM, AlarmRules::ABOVE, cfg.humMaxCenti, HUM_HYST_CENTI, 0, PRIORIDAD_CRITICA, ACCION_ALARMA, latch};
+    reglas[REGLA_HUM_BAJA] = {CANAL_HUM, AlarmRules::BELOW, cfg.humMinCenti, HUM_HYST_CENTI, 0, PRIORIDAD_CRITICA, ACCION_ALARMA, latch};
+    reglas[REGLA_LUZ_ALTA] = {CANAL_LUZ, AlarmRules::BELOW, (int16_t)luz.adcAlta(), LUZ_HYST_COUNTS, 0, PRIORIDAD_LUZ, ACCION_LUZ, 0};
+    reglas[REGLA_LUZ_BAJA] = {CANAL_LUZ, AlarmRules::ABOVE, (int16_t)luz.adcBaja(), LUZ_HYST_COUNTS, 0, PRIORIDAD_LUZ, ACCION_LUZ, 0};
+    reglas[REGLA_IR] = {CANAL_IR, AlarmRules::ABOVE, 0, 0, 0, PRIORIDAD_EVENTO, ACCION_PROXIMIDAD, 0};
+    reglas[REGLA_HALL] = {CANAL_HALL, AlarmRules::ABOVE, 0, 0, 0, PRIORIDAD_EVENTO, ACCION_MAGNETICO, 0};
+    alarms.refresh(); ///< Un umbral nuevo puede activar o liberar reglas
+    for (uint8_t i = 0; i < PAGINAS; i++) {
+        paginas[i].dwellMs = i == PAGINA_AMBIENTAL ? cfg.paginaAmbientalMs : cfg.paginaMs;
+    }
+}
+
+/**
+ * @brief Lee el fotoresistor en cuentas del ADC.
+ * 
+ * Única ruta de adquisición de luz del sistema. Devuelve el último valor 
+ * sobremuestreado por la ISR del ADC (16 conversiones), redondeado a la 
+ * escala de 10 bits de los umbrales y de la tabla de lux, así que no 
+ * espera ninguna conversión. Las decisiones de alerta se toman sobre este 
+ * valor filtrado (luzFiltrada()) con `luz`; la conversión a lux con 
+ * luxFromAdc() solo se hace cuando hay que mostrarla.
+ * 
+ * @return uint16_t Lectura del ADC (0–1023).
+ */
+uint16_t leerLuzAdc() {
+    return lightAdc.read10(); ///< Último bloque sobremuestreado
+}
+
+/**
+ * @brief Lectura del fotoresistor después del filtro.
+ * 
+ * @return uint16_t Cuentas del ADC (0–1023); si el filtro aún no recibió 
+ *         muestras, lee el ADC directamente.
+ */
+uint16_t luzFiltrada() {
+    return filtroLuz.primed() ? (uint16_t)filtroLuz.value() : leerLuzAdc();
+}
+
+/**
+ * @brief Temperatura filtrada en °C.
+ * 
+ * Solo tiene sentido si `dhtSampler.valid()`.
+ */
+float temperaturaFiltrada() {
+    return filtroTemp.value() / 100.0;
+}
+
+/**
+ * @brief Humedad filtrada en %.
+ * 
+ * Solo tiene sentido si `dhtSampler.valid()`.
+ */
+float humedadFiltrada() {
+    return filtroHum.value() / 100.0;
+}
+
+/**
+ * @brief Muestra un asterisco por cada dígito ingresado.
+ * 
+ * Escribe directamente en la segunda fila de la pantalla, sin construir 
+ * cadenas intermedias.
+ * 
+ * @param length Número de asteriscos.
+ */
+void mostrarAsteriscos(uint8_t length) {
+    pantalla.setCursor(0, 1); ///< Establece el cursor en la segunda fila
+    for (uint8_t i = 0; i < length; i++) { ///< Itera según la longitud
+        pantalla.write('*'); ///< Un asterisco por cada dígito ingresado
     }
-    return asterisks; ///< Retorna la cadena de asteriscos
 }
 
 /**
  * @brief Reinicia el sistema.
  * 
- * Limpia la contraseña ingresada y el contador de intentos.
+ * Limpia la contraseña ingresada. Los intentos fallidos no se borran: 
+ * solo los borra una clave correcta o el fin de un bloqueo.
  */
 void reset() {
-    inputPassword = ""; ///< Reinicia la entrada
-    attemptCount = 0; ///< Reinicia el contador de intentos
-    lcd.clear(); ///< Limpia el LCD
-    lcd.print("Ingrese la clave:"); ///< Muestra mensaje para ingresar clave
+    inputPassword.clear(); ///< Reinicia la entrada
+    pantalla.clear(); ///< Limpia la pantalla
+    pantalla.print("Ingrese la clave"); ///< Muestra mensaje para ingresar clave
 }
 
 /**
  * @brief Emite un sonido de alarma.
  * 
- * Produce un patrón de sonido para indicar una alarma.
+ * Inicia el patrón de alarma (1000 Hz y 500 Hz alternados, 5 veces) en 
+ * el secuenciador y retorna de inmediato.
  */
 void alarmSound() {
-    // Sonido de alarma
-    for (int i = 0; i < 5; i++) { ///< Repite el patrón 5 veces
-        tone(BUZZER_PIN, 1000, 250); ///< Tono de 1000 Hz durante 250 ms
-        delay(250); ///< Espera 250 ms
-        tone(BUZZER_PIN, 500, 250); ///< Tono de 500 Hz durante 250 ms
-        delay(250); ///< Espera 250 ms
-    }
-    noTone(BUZZER_PIN); ///< Detener el sonido del buzzer
+    buzzer.start(&PATRON_ALARMA); ///< Sonido de alarma
 }
 
 /**
  * @brief Emite un tono de bienvenida.
  * 
- * Produce un patrón de sonido para indicar un acceso exitoso.
+ * Inicia el patrón de bienvenida (do, mi, sol) en el secuenciador y 
+ * retorna de inmediato.
  */
 void welcomeTone() {
-    // Tono de bienvenida
-    tone(BUZZER_PIN, 262, 500); ///< Tono de do durante 500 ms
-    delay(500); ///< Espera 500 ms
-    tone(BUZZER_PIN, 330, 500); ///< Tono de mi durante 500 ms
-    delay(500); ///< Espera 500 ms
-    tone(BUZZER_PIN, 392, 500); ///< Tono de sol durante 500 ms
-    delay(500); ///< Espera 500 ms
-    noTone(BUZZER_PIN); ///< Detener el sonido del buzzer
+    buzzer.start(&PATRON_BIENVENIDA); ///< Tono de bienvenida
+}
+
+#if defined(BENCHMARK)
+volatile uint16_t benchAdc = 512; ///< Entrada de las pruebas de conversión (evita que se optimicen)
+volatile float benchLux; ///< Salida de las pruebas de conversión
+volatile bool benchNivel; ///< Salida de las pruebas de lectura de pines
+uint8_t benchPaso = 0; ///< Alterna el contenido del framebuffer entre repeticiones
+
+/**
+ * @brief Ejecuta el banco de pruebas y reporta por la UART.
+ * 
+ * El tick del monitoreo se mide con el estado ya activo y sin aviso, de 
+ * modo que dibuja en cada repetición; cada página del tablero también se 
+ * mide por separado. Las tramas binarias se suspenden mientras tanto para 
+ * no mezclarlas con el reporte. Al terminar deja el sistema como recién 
+ * encendido.
+ */
+void ejecutarBenchmarks() {
+    stream.setEnabled(false); ///< Solo texto por la UART mientras se mide
+    bench.begin();
+    Serial.print("bench iteraciones ");
+    Serial.print((unsigned int)BENCHMARK_ITERATIONS);
+    Serial.print("\r\n");
+
+    bench.run(Serial, "monitoreo", monitoreo, BENCHMARK_ITERATIONS, [] {
+        currentState = State::Monitoreo;
+        avisoEnPantalla = false;
+    });
+    bench.run(Serial, "paginaAmbiental", [] { paginaAmbiental(pantalla); }); ///< Cada página por separado
+    bench.run(Serial, "paginaLuz", [] { paginaLuz(pantalla); });
+    bench.run(Serial, "paginaPines", [] { paginaPines(pantalla); });
+    bench.run(Serial, "paginaRegistro", [] { paginaRegistro(pantalla); });
+    bench.run(Serial, "paginaEstadisticas", [] { paginaEstadisticas(pantalla); });
+    bench.run(Serial, "tareaVigilancia", tareaVigilancia, BENCHMARK_ITERATIONS, [] {
+        currentState = State::Monitoreo;
+    });
+    bench.run(Serial, "leerLuzAdc", [] { benchAdc = leerLuzAdc(); });
+    bench.run(Serial, "luxFromAdc", [] { benchLux = luxFromAdc(benchAdc); });
+    bench.run(Serial, "luxPow", [] { ///< Fórmula original en punto flotante, como referencia
+        float voltage = benchAdc / 1024. * 5;
+        float resistance = LDR_SERIES_OHMS * voltage / (1 - voltage / 5);
+        benchLux = pow(RL10 * 1e3 * pow(10, GAMMA) / resistance, (1 / GAMMA));
+    });
+    bench.run(Serial, "digitalWrite", [] { digitalWrite(Board::LED_BLUE, LOW); }); ///< Búsqueda de puerto en cada llamada
+    bench.run(Serial, "fastPinWrite", [] { Board::LedBlue::low(); }); ///< Registro y máscara fijos
+    bench.run(Serial, "ledPwmTick", [] { leds.pwmTick(); }); ///< Cuerpo de la ISR del Timer4
+    bench.run(Serial, "digitalRead", [] { benchNivel = digitalRead(INFRARED_PIN); });
+    bench.run(Serial, "fastPinRead", [] { benchNivel = Board::Infrared::read(); });
+    bench.run(Serial, "pinEventsIsr", [] { pinEvents.handleChange(); }); ///< Cuerpo de la ISR sin flancos nuevos
+    bench.run(Serial, "lcdClearPrint", [] { ///< Redibujo directo, como antes del framebuffer
+        lcd.clear();
+        lcd.print("Moni Eventos");
+        lcd.setCursor(0, 1);
+        lcd.print("Luz : 350");
+    });
+    bench.run(Serial, "pantallaFlush", [] { pantalla.flush(); }, BENCHMARK_ITERATIONS, [] {
+        pantalla.clear();
+        pantalla.print("Moni Eventos");
+        pantalla.setCursor(0, 1);
+        pantalla.print("Luz : ");
+        pantalla.print(350 + (benchPaso++ & 1)); ///< Un solo carácter cambia por repetición
+    });
+    bench.run(Serial, "pantallaFlushIgual", [] { pantalla.flush(); });
+
+    buzzer.stop();
+    leds.stopAll();
+    cambiarEstado(State::Login); ///< Vuelve al ingreso de la clave
+    pantalla.invalidate(); ///< lcdClearPrint escribió por fuera del framebuffer
+    reset();
+    scheduler.resetStats();
+    Serial.print("bench fin\r\n");
+    stream.setEnabled(true);
 }
+#endif
@@ -0,0 +1,25 @@
+/**
+ * @file EepromLayout.h
+ * @brief Mapa de la EEPROM interna.
+ *
+ * Todas las regiones persistentes se reservan aquí para que no se
+ * solapen. El ATmega2560 tiene 4 KB de EEPROM.
+ */
+
+#ifndef EEPROM_LAYOUT_H
+#define EEPROM_LAYOUT_H
+
+#include <Arduino.h>
+
+#if defined(E2END)
+const uint16_t EEPROM_SIZE_BYTES = E2END + 1; ///< Tamaño de la EEPROM
+#else
+const uint16_t EEPROM_SIZE_BYTES = 4096; ///< Tamaño de la EEPROM
+#endif
+
+const uint16_t EEPROM_CONFIG_START = 0; ///< Bloque de configuración del sitio (Settings, 0–63)
+const uint16_t EEPROM_LOCKOUT_START = 64; ///< Intentos fallidos y nivel de bloqueo (Lockout)
+const uint16_t EEPROM_LOG_START = 256; ///< Inicio del registro de telemetría (0–255 reservado)
+const uint16_t EEPROM_LOG_END = EEPROM_SIZE_BYTES; ///< Fin (exclusivo) del registro de telemetría
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file FastPin.h
+ * @brief Acceso directo a un pin digital resuelto en tiempo de compilación.
+ *
+ * digitalWrite() y digitalRead() buscan puerto y máscara en tablas de
+ * memoria de programa en cada llamada (~50 ciclos). FastPin<N> calcula el
+ * registro y la máscara del pin N al compilar: en los puertos A–G del
+ * ATmega2560, que están en el espacio de E/S, escribir o leer es una sola
+ * instrucción (sbi, cbi, sbic). Los puertos H–L están fuera de ese
+ * espacio; ahí la escritura es lectura-modificación-escritura y se hace
+ * con las interrupciones deshabilitadas.
+ *
+ * En otros procesadores y en la simulación se usan las funciones de
+ * Arduino, con el mismo comportamiento.
+ */
+
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+#if defined(__AVR_ATmega2560__)
+
+namespace fastpin {
+
+/**
+ * @brief Dirección del registro PINx de cada pin del Mega (DDRx = +1, PORTx = +2).
+ */
+constexpr uint16_t PIN_REG[70] = {
+    0x2C, 0x2C, 0x2C, 0x2C, 0x32, 0x2C, 0x100, 0x100, 0x100, 0x100, ///< D0–D9
+    0x23, 0x23, 0x23, 0x23, 0x103, 0x103, 0x100, 0x100, 0x29, 0x29, ///< D10–D19
+    0x29, 0x29, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, ///< D20–D29
+    0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x29, 0x32, ///< D30–D39
+    0x32, 0x32, 0x109, 0x109, 0x109, 0x109, 0x109, 0x109, 0x109, 0x109, ///< D40–D49
+    0x23, 0x23, 0x23, 0x23, 0x2F, 0x2F, 0x2F, 0x2F, 0x2F, 0x2F, ///< D50–D59
+    0x2F, 0x2F, 0x106, 0x106, 0x106, 0x106, 0x106, 0x106, 0x106, 0x106 ///< D60–D69
+};
+
+/**
+ * @brief Bit de cada pin del Mega dentro de su puerto.
+ */
+constexpr uint8_t PIN_BIT[70] = {
+    0, 1, 4, 5, 5, 3, 3, 4, 5, 6, ///< D0–D9
+    4, 5, 6, 7, 1, 0, 1, 0, 3, 2, ///< D10–D19
+    1, 0, 0, 1, 2, 3, 4, 5, 6, 7, ///< D20–D29
+    7, 6, 5, 4, 3, 2, 1, 0, 7, 2, ///< D30–D39
+    1, 0, 7, 6, 5, 4, 3, 2, 1, 0, ///< D40–D49
+    3, 2, 1, 0, 0, 1, 2, 3, 4, 5, ///< D50–D59
+    6, 7, 0, 1, 2, 3, 4, 5, 6, 7 ///< D60–D69
+};
+
+} // namespace fastpin
+
+/**
+ * @brief Pin digital N con registros fijos.
+ */
+template <uint8_t N>
+class FastPin {
+    static_assert(N < 70, "El ATmega2560 tiene los pines 0 a 69");
+
+    static constexpr uint16_t PIN_ADDR = fastpin::PIN_REG[N];
+    static constexpr uint8_t MASK = 1 << fastpin::PIN_BIT[N];
+    static constexpr bool IO_SPACE = PIN_ADDR + 2 < 0x40; ///< sbi/cbi alcanzan el registro
+
+    static volatile uint8_t& pinReg() { return *(volatile uint8_t*)PIN_ADDR; }
+    static volatile uint8_t& ddrReg() { return *(volatile uint8_t*)(PIN_ADDR + 1); }
+    static volatile uint8_t& portReg() { return *(volatile uint8_t*)(PIN_ADDR + 2); }
+
+    static void set(volatile uint8_t& reg, bool on) {
+        if (IO_SPACE) { ///< Una instrucción: ya es atómica
+            if (on) reg |= MASK; else reg &= ~MASK;
+            return;
+        }
+        uint8_t oldSREG = SREG;
+        cli(); ///< Una ISR no debe cambiar otro bit del puerto entre lectura y escritura
+        if (on) reg |= MASK; else reg &= ~MASK;
+        SREG = oldSREG;
+    }
+
+public:
+    static const uint8_t PIN = N; ///< Número de pin de Arduino
+
+    static void output() { set(ddrReg(), true); } ///< Configura el pin como salida
+    static void input() { set(ddrReg(), false); set(portReg(), false); } ///< Entrada sin pull-up
+    static void high() { set(portReg(), true); } ///< Nivel alto
+    static void low() { set(portReg(), false); } ///< Nivel bajo
+    static void write(bool level) { set(portReg(), level); } ///< Fija el nivel
+    static void toggle() { pinReg() = MASK; } ///< Invierte la salida (escribir 1 en PINx)
+    static bool read() { return pinReg() & MASK; } ///< Nivel actual del pin
+};
+
+#else
+
+/**
+ * @brief Pin digital N sobre las funciones de Arduino.
+ */
+template <uint8_t N>
+class FastPin {
+public:
+    static const uint8_t PIN = N; ///< Número de pin de Arduino
+
+    static void output() { pinMode(N, OUTPUT); }
+    static void input() { pinMode(N, INPUT); }
+    static void high() { digitalWrite(N, HIGH); }
+    static void low() { digitalWrite(N, LOW); }
+    static void write(bool level) { digitalWrite(N, level ? HIGH : LOW); }
+    static void toggle() { digitalWrite(N, digitalRead(N) == HIGH ? LOW : HIGH); }
+    static bool read() { return digitalRead(N) == HIGH; }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file KeypadScanner.cpp
+ * @brief Implementación del barrido del teclado por interrupción.
+ */
+
+#include "KeypadScanner.h"
+#include "PowerManager.h"
+
+KeypadScanner::KeypadScanner(const char* keymap, const byte* rowPins, const byte* colPins)
+    : keymap(keymap), lastRaw(0), stable(0) {
+    for (uint8_t r = 0; r < ROWS; r++) rows[r] = regsFor(rowPins[r]);
+    for (uint8_t c = 0; c < COLS; c++) cols[c] = regsFor(colPins[c]);
+    memset(heldScans, 0, sizeof(heldScans));
+}
+
+KeypadScanner::PinRegs KeypadScanner::regsFor(uint8_t pin) {
+    uint8_t port = digitalPinToPort(pin);
+    PinRegs regs = {portModeRegister(port), portOutputRegister(port), portInputRegister(port),
+                    (uint8_t)digitalPinToBitMask(pin)};
+    return regs;
+}
+
+void KeypadScanner::begin() {
+    for (uint8_t r = 0; r < ROWS; r++) {
+        *rows[r].mode &= ~rows[r].mask; ///< Entrada
+        *rows[r].output |= rows[r].mask; ///< Con pull-up
+    }
+    for (uint8_t c = 0; c < COLS; c++) {
+        *cols[c].mode &= ~cols[c].mask; ///< Alta impedancia mientras no se barre
+        *cols[c].output &= ~cols[c].mask; ///< Al activarla como salida queda en LOW
+    }
+
+#if defined(__AVR__) && defined(TCCR3A)
+    uint8_t oldSREG = SREG;
+    cli();
+    TCCR3A = 0;
+    TCCR3B = bit(WGM32) | bit(CS32); ///< Modo CTC, preescalador 256
+    TCNT3 = 0;
+    OCR3A = F_CPU / 256 / SCAN_HZ - 1; ///< 624 a 16 MHz: 100 Hz
+    TIFR3 = bit(OCF3A);
+    TIMSK3 |= bit(OCIE3A);
+    SREG = oldSREG;
+#endif
+}
+
+void KeypadScanner::scan() {
+    uint16_t raw = 0;
+    for (uint8_t c = 0; c < COLS; c++) {
+        *cols[c].mode |= cols[c].mask; ///< Columna activa en LOW
+        delayMicroseconds(2); ///< Asentamiento de la línea
+        for (uint8_t r = 0; r < ROWS; r++) {
+            if (!(*rows[r].input & rows[r].mask)) { ///< Fila en LOW: tecla presionada
+                raw |= 1u << (r * COLS + c);
+            }
+        }
+        *cols[c].mode &= ~cols[c].mask; ///< Vuelve a alta impedancia
+    }
+
+    // Antirrebote: un cambio se acepta si se repite en dos barridos seguidos.
+    uint16_t changed = 0;
+    if (raw == lastRaw) {
+        changed = raw ^ stable;
+        stable = raw;
+    }
+    lastRaw = raw;
+
+    const uint8_t holdScans = (uint32_t)HOLD_MS * SCAN_HZ / 1000;
+    for (uint8_t i = 0; i < ROWS * COLS; i++) {
+        uint16_t m = 1u << i;
+        if (changed & m) {
+            KeyEvent e = {keymap[i], (uint8_t)((stable & m) ? KeyEvent::PRESS : KeyEvent::RELEASE)};
+            queue.push(e);
+            heldScans[i] = 0;
+            PowerManager::requestWake(); ///< El bucle debe atender la tecla cuanto antes
+        } else if ((stable & m) && heldScans[i] < holdScans) {
+            if (++heldScans[i] == holdScans) {
+                KeyEvent e = {keymap[i], KeyEvent::HOLD};
+                queue.push(e);
+                PowerManager::requestWake();
+            }
+        }
+    }
+}
+
+#if defined(__AVR__) && defined(TIMER3_COMPA_vect)
+ISR(TIMER3_COMPA_vect) {
+    keypad.scan();
+}
+#endif
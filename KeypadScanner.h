@@ -0,0 +1,91 @@
+/**
+ * @file KeypadScanner.h
+ * @brief Barrido del teclado matricial 4x4 desde una interrupción de timer.
+ *
+ * Con keypad.getKey() las teclas solo se leen cuando el bucle pasa por
+ * ahí, y cualquier espera las pierde. Aquí el Timer3 dispara una ISR a
+ * 100 Hz que barre la matriz, elimina rebotes y deja eventos de tecla
+ * presionada, soltada o mantenida en una cola que el bucle consume cuando
+ * puede, lo que además permite escribir por adelantado.
+ */
+
+#ifndef KEYPAD_SCANNER_H
+#define KEYPAD_SCANNER_H
+
+#include <Arduino.h>
+#include "RingBuffer.h"
+
+/**
+ * @brief Evento del teclado.
+ */
+struct KeyEvent {
+    /**
+     * @brief Tipo de evento.
+     */
+    enum Type {
+        PRESS, ///< La tecla se presionó
+        RELEASE, ///< La tecla se soltó
+        HOLD ///< La tecla lleva @c KeypadScanner::HOLD_MS presionada
+    };
+
+    char key; ///< Carácter de la tecla
+    uint8_t type; ///< Tipo de evento (Type)
+};
+
+/**
+ * @brief Barredor de la matriz con antirrebote y cola de eventos.
+ */
+class KeypadScanner {
+public:
+    static const uint8_t ROWS = 4; ///< Filas de la matriz
+    static const uint8_t COLS = 4; ///< Columnas de la matriz
+    static const uint8_t SCAN_HZ = 100; ///< Frecuencia de barrido
+    static const uint16_t HOLD_MS = 1000; ///< Tiempo para considerar una tecla mantenida
+    static const uint8_t QUEUE_SIZE = 16; ///< Posiciones de la cola de eventos
+
+    /**
+     * @param keymap Caracteres de la matriz, ROWS x COLS por filas.
+     * @param rowPins Pines de las filas (entradas con pull-up).
+     * @param colPins Pines de las columnas (se llevan a LOW de a una).
+     */
+    KeypadScanner(const char* keymap, const byte* rowPins, const byte* colPins);
+
+    void begin(); ///< Configura los pines y arranca el Timer3
+
+    /**
+     * @brief Barre la matriz una vez y encola los cambios.
+     *
+     * La llama la ISR del Timer3; en plataformas sin ese timer puede
+     * llamarse desde el bucle a @c SCAN_HZ.
+     */
+    void scan();
+
+    bool pop(KeyEvent& event) { return queue.pop(event); } ///< Extrae el evento más antiguo
+    uint16_t pressedMask() const { return stable; } ///< Teclas presionadas (un bit por tecla)
+    uint16_t overflows() const { return queue.overflows(); } ///< Eventos perdidos por cola llena
+
+private:
+    /**
+     * @brief Registros de un pin.
+     */
+    struct PinRegs {
+        volatile uint8_t* mode; ///< DDRx
+        volatile uint8_t* output; ///< PORTx
+        volatile uint8_t* input; ///< PINx
+        uint8_t mask; ///< Bit del pin
+    };
+
+    static PinRegs regsFor(uint8_t pin); ///< Resuelve los registros de un pin
+
+    const char* keymap; ///< Caracteres de la matriz
+    PinRegs rows[ROWS]; ///< Registros de las filas
+    PinRegs cols[COLS]; ///< Registros de las columnas
+    uint16_t lastRaw; ///< Lectura cruda del barrido anterior
+    uint16_t stable; ///< Estado sin rebote
+    uint8_t heldScans[ROWS * COLS]; ///< Barridos que lleva presionada cada tecla
+    RingBuffer<KeyEvent, QUEUE_SIZE> queue; ///< Cola ISR → bucle principal
+};
+
+extern KeypadScanner keypad; ///< Teclado del sistema
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file LcdBuffer.cpp
+ * @brief Implementación del framebuffer del LCD.
+ */
+
+#include "LcdBuffer.h"
+
+LcdBuffer::LcdBuffer(LiquidCrystal& lcd) : lcd(lcd), col(0), row(0), forced(false) {
+    memset(frame, ' ', sizeof(frame));
+    memset(shown, ' ', sizeof(shown));
+}
+
+void LcdBuffer::begin() {
+    lcd.clear(); ///< Única limpieza física: deja el LCD igual que la copia
+    memset(frame, ' ', sizeof(frame));
+    memset(shown, ' ', sizeof(shown));
+    col = 0;
+    row = 0;
+    forced = false;
+}
+
+void LcdBuffer::clear() {
+    memset(frame, ' ', sizeof(frame));
+    col = 0;
+    row = 0;
+}
+
+void LcdBuffer::setCursor(uint8_t c, uint8_t r) {
+    col = c;
+    row = r;
+}
+
+void LcdBuffer::setLine(uint8_t r, const char* text) {
+    if (r >= ROWS) return;
+    uint8_t c = 0;
+    while (c < COLS && text[c]) {
+        frame[r][c] = text[c];
+        c++;
+    }
+    while (c < COLS) {
+        frame[r][c++] = ' '; ///< Rellena el resto de la fila
+    }
+}
+
+void LcdBuffer::printAt(uint8_t c, uint8_t r, const char* text) {
+    setCursor(c, r);
+    print(text);
+}
+
+size_t LcdBuffer::write(uint8_t c) {
+    if (row < ROWS && col < COLS) {
+        frame[row][col] = c;
+    }
+    col++; ///< Avanza aunque se salga, para que el resto del texto también se descarte
+    return 1;
+}
+
+uint8_t LcdBuffer::flush() {
+    uint8_t sent = 0;
+    for (uint8_t r = 0; r < ROWS; r++) {
+        bool positioned = false; ///< Indica si el cursor del LCD ya está en c
+        for (uint8_t c = 0; c < COLS; c++) {
+            if (!forced && frame[r][c] == shown[r][c]) {
+                positioned = false; ///< Se rompe el tramo contiguo
+                continue;
+            }
+            if (!positioned) {
+                lcd.setCursor(c, r);
+                positioned = true;
+            }
+            lcd.write(frame[r][c]); ///< El LCD avanza su cursor solo
+            shown[r][c] = frame[r][c];
+            sent++;
+        }
+    }
+    forced = false;
+    return sent;
+}
+
+void LcdBuffer::defineGlyph(uint8_t slot, const uint8_t* bitmap) {
+    uint8_t rows[8];
+    memcpy_P(rows, bitmap, sizeof(rows)); ///< LiquidCrystal espera el mapa en RAM
+    lcd.createChar(slot, rows); ///< Deja el LCD direccionando la CGRAM: flush() siempre posiciona antes de escribir
+}
+
+void LcdBuffer::invalidate() {
+    forced = true; ///< El próximo flush() reenvía todos los caracteres
+}
@@ -0,0 +1,87 @@
+/**
+ * @file LcdBuffer.h
+ * @brief Framebuffer de 16x2 con envío diferencial al LCD.
+ *
+ * En un HD44780 de 4 bits, clear() tarda cerca de 2 ms y provoca parpadeo.
+ * Este módulo mantiene una copia de lo que debería verse y otra de lo que
+ * ya está en la pantalla; flush() compara ambas y solo envía los
+ * caracteres que cambiaron, con un setCursor() por cada tramo contiguo.
+ * Hereda de Print, así que admite las mismas llamadas print() que el LCD.
+ * Los caracteres propios (códigos 0–7 del HD44780) se cargan con
+ * defineGlyph() y se escriben como cualquier otro.
+ */
+
+#ifndef LCD_BUFFER_H
+#define LCD_BUFFER_H
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+
+/**
+ * @brief Pantalla virtual con diferencias contra el LCD físico.
+ */
+class LcdBuffer : public Print {
+public:
+    static const uint8_t COLS = 16; ///< Columnas del LCD
+    static const uint8_t ROWS = 2; ///< Filas del LCD
+
+    explicit LcdBuffer(LiquidCrystal& lcd);
+
+    void begin(); ///< Limpia el LCD físico una sola vez y sincroniza la copia
+
+    void clear(); ///< Llena el buffer con espacios y lleva el cursor al origen (sin tocar el LCD)
+    void setCursor(uint8_t col, uint8_t row); ///< Posiciona el cursor del buffer
+
+    /**
+     * @brief Reemplaza una fila completa, rellenando con espacios.
+     */
+    void setLine(uint8_t row, const char* text);
+
+    /**
+     * @brief Escribe texto en una posición sin alterar el resto de la fila.
+     */
+    void printAt(uint8_t col, uint8_t row, const char* text);
+
+    /**
+     * @brief Escribe un carácter en el cursor del buffer.
+     *
+     * Los caracteres fuera de la pantalla se descartan.
+     */
+    size_t write(uint8_t c);
+    using Print::write;
+
+    /**
+     * @brief Envía al LCD solo los caracteres distintos.
+     *
+     * @return uint8_t Número de caracteres enviados.
+     */
+    uint8_t flush();
+
+    /**
+     * @brief Marca toda la pantalla como desconocida para forzar un reenvío.
+     */
+    void invalidate();
+
+    /**
+     * @brief Carga un carácter propio en la CGRAM del LCD.
+     *
+     * Los caracteres ya visibles con ese código cambian de inmediato, sin
+     * reenviarlos.
+     *
+     * @param slot Código del carácter (0–7).
+     * @param bitmap Ocho filas de 5 bits, en memoria de programa.
+     */
+    void defineGlyph(uint8_t slot, const uint8_t* bitmap);
+
+    char charAt(uint8_t col, uint8_t row) const { return frame[row][col]; } ///< Carácter del buffer
+
+private:
+    LiquidCrystal& lcd; ///< LCD físico
+    char frame[ROWS][COLS]; ///< Contenido deseado
+    char shown[ROWS][COLS]; ///< Contenido actual del LCD
+    uint8_t col; ///< Columna del cursor
+    uint8_t row; ///< Fila del cursor
+    bool forced; ///< Reenviar todo en el próximo flush()
+};
+
+#endif
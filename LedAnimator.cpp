@@ -0,0 +1,134 @@
+/**
+ * @file LedAnimator.cpp
+ * @brief Implementación de las animaciones de los LEDs.
+ */
+
+#include "LedAnimator.h"
+
+LedAnimator leds;
+
+LedAnimator::LedAnimator() : channelCount(0), pwmStep(0) {}
+
+int8_t LedAnimator::addChannel(uint8_t pin) {
+    if (channelCount >= MAX_CHANNELS) {
+        return -1;
+    }
+    Channel& c = channels[channelCount];
+    uint8_t port = digitalPinToPort(pin);
+    c.output = portOutputRegister(port);
+    c.mask = digitalPinToBitMask(pin);
+    memset(c.tracks, 0, sizeof(c.tracks));
+    c.duty = 0;
+    pinMode(pin, OUTPUT);
+    *c.output &= ~c.mask; ///< Apagado hasta el primer patrón
+    return channelCount++;
+}
+
+void LedAnimator::begin() {
+#if defined(__AVR__) && defined(TCCR4A)
+    uint8_t oldSREG = SREG;
+    cli();
+    TCCR4A = 0;
+    TCCR4B = bit(WGM42) | bit(CS41); ///< Modo CTC, preescalador 8
+    TCNT4 = 0;
+    OCR4A = F_CPU / 8 / (LEVELS * (1000 / FRAME_MS)) - 1; ///< 624 a 16 MHz: 3200 pasos por segundo
+    TIFR4 = bit(OCF4A);
+    TIMSK4 |= bit(OCIE4A);
+    SREG = oldSREG;
+#endif
+}
+
+void LedAnimator::play(uint8_t channel, uint8_t layer, uint8_t shape, uint16_t periodMs, uint16_t durationMs) {
+    if (channel >= channelCount || layer >= LAYERS) {
+        return;
+    }
+    Track t;
+    t.shape = shape;
+    t.periodFrames = periodMs >= FRAME_MS ? periodMs / FRAME_MS : 1;
+    t.phase = 0;
+    t.framesLeft = durationMs ? (durationMs + FRAME_MS - 1) / FRAME_MS : 0;
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli(); ///< La ISR no debe ver la capa a medio escribir
+#endif
+    channels[channel].tracks[layer] = t;
+#if defined(__AVR__)
+    SREG = oldSREG;
+#endif
+}
+
+void LedAnimator::stopAll() {
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+#endif
+    for (uint8_t i = 0; i < channelCount; i++) {
+        memset(channels[i].tracks, 0, sizeof(channels[i].tracks));
+    }
+#if defined(__AVR__)
+    SREG = oldSREG;
+#endif
+}
+
+uint8_t LedAnimator::level(const Track& t) {
+    switch (t.shape) {
+    case SOLID:
+        return LEVELS;
+    case BLINK:
+        return t.phase < t.periodFrames / 2 ? LEVELS : 0;
+    case PULSE:
+        return t.phase <= t.periodFrames / 8 ? LEVELS : 0;
+    case BREATHE: {
+        uint16_t half = t.periodFrames / 2;
+        if (!half) return LEVELS;
+        uint16_t x = t.phase < half ? t.phase : t.periodFrames - t.phase;
+        if (x > half) x = half;
+        uint16_t lineal = (uint32_t)x * LEVELS / half;
+        return lineal * lineal / LEVELS; ///< Curva cuadrática: el ojo percibe el brillo así
+    }
+    default:
+        return 0;
+    }
+}
+
+void LedAnimator::frame() {
+    int8_t top = -1; ///< Capa más alta activa en algún canal
+    for (uint8_t i = 0; i < channelCount; i++) {
+        for (uint8_t l = 0; l < LAYERS; l++) {
+            Track& t = channels[i].tracks[l];
+            if (t.shape == OFF) continue;
+            if (t.framesLeft && --t.framesLeft == 0) {
+                t.shape = OFF; ///< Se cumplió la duración
+                continue;
+            }
+            if (++t.phase >= t.periodFrames) t.phase = 0;
+            if ((int8_t)l > top) top = l;
+        }
+    }
+    for (uint8_t i = 0; i < channelCount; i++) {
+        Channel& c = channels[i];
+        c.duty = top >= 0 ? level(c.tracks[top]) : 0;
+#if !(defined(__AVR__) && defined(TIMER4_COMPA_vect))
+        if (c.duty >= LEVELS / 2) *c.output |= c.mask; ///< Sin PWM: encendido o apagado
+        else *c.output &= ~c.mask;
+#endif
+    }
+}
+
+void LedAnimator::pwmTick() {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        Channel& c = channels[i];
+        if (c.duty > pwmStep) *c.output |= c.mask; ///< Con interrupciones deshabilitadas: PORTH es seguro
+        else *c.output &= ~c.mask;
+    }
+    if (++pwmStep >= LEVELS) {
+        pwmStep = 0;
+        frame();
+    }
+}
+
+#if defined(__AVR__) && defined(TIMER4_COMPA_vect)
+ISR(TIMER4_COMPA_vect) {
+    leds.pwmTick();
+}
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file LedAnimator.h
+ * @brief Animaciones de los LEDs de estado por PWM desde una interrupción.
+ *
+ * Cada LED es un canal con varias capas de prioridad (estado, evento,
+ * alarma); cada capa puede tener un patrón (fijo, parpadeo, respiración o
+ * destello) con una duración opcional. Se muestra la capa más alta activa
+ * en cualquiera de los canales y los demás canales se apagan si no tienen
+ * un patrón en esa capa, de modo que la alarma en rojo tapa el verde de
+ * estado sin que el sketch lo apague y lo vuelva a encender.
+ *
+ * Los pines 9 y 10 del Mega son OC2B y OC2A: su PWM por hardware es del
+ * Timer2, que ocupa tone(). Por eso el brillo se genera por software en
+ * la ISR de comparación del Timer4, que además avanza las animaciones una
+ * vez por periodo de PWM. El bucle principal solo elige patrones.
+ */
+
+#ifndef LED_ANIMATOR_H
+#define LED_ANIMATOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Canales de LED con patrones por capas.
+ */
+class LedAnimator {
+public:
+    /**
+     * @brief Forma del patrón dentro de su periodo.
+     */
+    enum Shape : uint8_t {
+        OFF, ///< Sin patrón en la capa
+        SOLID, ///< Encendido fijo
+        BLINK, ///< Encendido la primera mitad del periodo
+        BREATHE, ///< Sube y baja el brillo a lo largo del periodo
+        PULSE ///< Destello corto al comienzo del periodo
+    };
+
+    /**
+     * @brief Capas de prioridad, de menor a mayor.
+     */
+    enum Layer : uint8_t {
+        LAYER_STATUS, ///< Estado del sistema (armado, etc.)
+        LAYER_EVENT, ///< Avisos breves (sensores, bienvenida)
+        LAYER_ALARM, ///< Alarma y bloqueo
+        LAYERS ///< Número de capas
+    };
+
+    static const uint8_t MAX_CHANNELS = 3; ///< LEDs que se animan
+    static const uint8_t LEVELS = 32; ///< Niveles de brillo del PWM
+    static const uint8_t FRAME_MS = 10; ///< Periodo del PWM y paso de las animaciones
+
+    LedAnimator();
+
+    /**
+     * @brief Registra un LED.
+     *
+     * Debe llamarse antes de begin().
+     *
+     * @return Índice del canal, o -1 si no hay lugar.
+     */
+    int8_t addChannel(uint8_t pin);
+
+    void begin(); ///< Configura los pines y arranca el Timer4
+
+    /**
+     * @brief Pone un patrón en una capa de un canal.
+     *
+     * @param channel Canal devuelto por addChannel().
+     * @param layer Capa (`Layer`).
+     * @param shape Forma (`Shape`).
+     * @param periodMs Periodo del patrón (ignorado en SOLID).
+     * @param durationMs Tiempo tras el cual la capa se libera (0 = sin fin).
+     */
+    void play(uint8_t channel, uint8_t layer, uint8_t shape, uint16_t periodMs = 1000, uint16_t durationMs = 0);
+
+    void stop(uint8_t channel, uint8_t layer) { play(channel, layer, OFF); } ///< Libera una capa de un canal
+    void stopAll(); ///< Libera todas las capas de todos los canales
+
+    uint8_t brightness(uint8_t channel) const { return channels[channel].duty; } ///< Brillo actual (0–LEVELS)
+
+    /**
+     * @brief Un paso del PWM; la llama la ISR del Timer4.
+     *
+     * Cada @c LEVELS pasos avanza las animaciones con frame().
+     */
+    void pwmTick();
+
+    /**
+     * @brief Avanza las animaciones @c FRAME_MS y calcula los brillos.
+     *
+     * Sin Timer4 (en el host) la llama el bucle cada @c FRAME_MS y fija
+     * cada LED encendido si su brillo pasa la mitad.
+     */
+    void frame();
+
+private:
+    /**
+     * @brief Patrón de una capa.
+     */
+    struct Track {
+        uint8_t shape; ///< Forma (`Shape`)
+        uint16_t periodFrames; ///< Periodo en pasos de @c FRAME_MS
+        uint16_t phase; ///< Paso actual dentro del periodo
+        uint16_t framesLeft; ///< Pasos hasta liberarse (0 = sin fin)
+    };
+
+    /**
+     * @brief Un LED.
+     */
+    struct Channel {
+        volatile uint8_t* output; ///< PORTx
+        uint8_t mask; ///< Bit del pin
+        Track tracks[LAYERS]; ///< Patrón de cada capa
+        uint8_t duty; ///< Brillo que aplica el PWM
+    };
+
+    static uint8_t level(const Track& t); ///< Brillo de un patrón en su paso actual
+
+    Channel channels[MAX_CHANNELS];
+    uint8_t channelCount;
+    uint8_t pwmStep; ///< Paso dentro del periodo de PWM
+};
+
+extern LedAnimator leds; ///< LEDs de estado del sistema
+
+#endif
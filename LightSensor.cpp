@@ -0,0 +1,114 @@
+/**
+ * @file LightSensor.cpp
+ * @brief Tabla ADC → lux generada en tiempo de compilación.
+ *
+ * Las funciones matemáticas se escriben como constexpr de una sola
+ * expresión (C++11) para que el compilador evalúe toda la tabla.
+ */
+
+#include "LightSensor.h"
+
+namespace {
+
+constexpr double LN2 = 0.69314718055994531; ///< ln(2)
+constexpr double LN10 = 2.30258509299404568; ///< ln(10)
+
+/** Serie de atanh para ln(x) con x en [1, 2): 2·Σ z^(2n+1)/(2n+1). */
+constexpr double lnSeries(double z2, double term, int n) {
+    return n > 41 ? 0 : term / n + lnSeries(z2, term * z2, n + 2);
+}
+
+/** Logaritmo natural con reducción del argumento a [1, 2). */
+constexpr double cLn(double x) {
+    return x >= 2 ? cLn(x / 2) + LN2
+         : x < 1 ? cLn(x * 2) - LN2
+         : 2 * lnSeries(((x - 1) / (x + 1)) * ((x - 1) / (x + 1)), (x - 1) / (x + 1), 1);
+}
+
+/** Serie de Taylor de e^x para |x| <= 1. */
+constexpr double expSeries(double x, double term, int n) {
+    return n > 20 ? 0 : term + expSeries(x, term * x / n, n + 1);
+}
+
+constexpr double cSquare(double x) {
+    return x * x;
+}
+
+/** Exponencial con reducción por mitades: e^x = (e^(x/2))². */
+constexpr double cExp(double x) {
+    return (x > 1 || x < -1) ? cSquare(cExp(x / 2)) : expSeries(x, 1, 1);
+}
+
+/** Resistencia del LDR para una lectura del ADC (misma fórmula que el sketch). */
+constexpr double ldrResistance(double voltage) {
+    return LDR_SERIES_OHMS * voltage / (1 - voltage / 5);
+}
+
+/**
+ * ln(lux) = (ln(RL10·1e3) + GAMMA·ln(10) − ln(R)) / GAMMA, equivalente a
+ * pow(RL10 * 1e3 * pow(10, GAMMA) / R, 1 / GAMMA).
+ */
+constexpr double lnLux(double resistance) {
+    return (cLn(RL10 * 1e3) + GAMMA * LN10 - cLn(resistance)) / GAMMA;
+}
+
+constexpr uint16_t luxFromLn(double ln) {
+    return ln >= cLn(LUX_MAX) ? LUX_MAX : (uint16_t)(cExp(ln) + 0.5);
+}
+
+/** Lux para un valor del ADC; 0 se satura (resistencia nula). */
+constexpr uint16_t luxForAdc(uint16_t adc) {
+    return adc == 0 ? LUX_MAX : luxFromLn(lnLux(ldrResistance(adc / (double)ADC_STEPS * 5)));
+}
+
+// Secuencia de índices 0..N-1 construida por mitades para no exceder la
+// profundidad de instanciación de plantillas del compilador.
+template <uint16_t... I> struct Seq {};
+
+template <class A, class B> struct Concat;
+template <uint16_t... A, uint16_t... B> struct Concat<Seq<A...>, Seq<B...> > {
+    typedef Seq<A..., (uint16_t)(sizeof...(A) + B)...> type;
+};
+
+template <uint16_t N> struct MakeSeq {
+    typedef typename Concat<typename MakeSeq<N / 2>::type, typename MakeSeq<N - N / 2>::type>::type type;
+};
+template <> struct MakeSeq<0> { typedef Seq<> type; };
+template <> struct MakeSeq<1> { typedef Seq<0> type; };
+
+template <class S> struct LuxTable;
+template <uint16_t... I> struct LuxTable<Seq<I...> > {
+    static const uint16_t values[sizeof...(I)];
+};
+template <uint16_t... I>
+const uint16_t LuxTable<Seq<I...> >::values[sizeof...(I)] PROGMEM = {luxForAdc(I)...};
+
+typedef LuxTable<MakeSeq<ADC_STEPS>::type> Table; ///< Tabla de 1024 entradas en PROGMEM
+
+} // namespace
+
+uint16_t luxFromAdc(uint16_t adc) {
+    if (adc >= ADC_STEPS) adc = ADC_STEPS - 1;
+    return pgm_read_word(&Table::values[adc]);
+}
+
+uint16_t adcForLux(uint16_t lux) {
+    uint16_t lo = 0;
+    uint16_t hi = ADC_STEPS - 1;
+    while (lo < hi) { ///< Búsqueda binaria sobre la tabla decreciente
+        uint16_t mid = (lo + hi) / 2;
+        if (luxFromAdc(mid) <= lux) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+LightThreshold::LightThreshold() : adcHigh(0), adcLow(ADC_STEPS - 1) {}
+
+void LightThreshold::begin(uint16_t luxAlta, uint16_t luxBaja) {
+    adcHigh = adcForLux(luxAlta); ///< lux > luxAlta  <=>  adc < adcHigh
+    adcLow = adcForLux(luxBaja - 1) - 1; ///< lux < luxBaja  <=>  adc > adcLow
+}
@@ -0,0 +1,82 @@
+/**
+ * @file LightSensor.h
+ * @brief Conversión de la lectura del fotoresistor a lux por tabla.
+ *
+ * La fórmula del LDR necesita dos pow() en punto flotante por muestra,
+ * muy costosas en un AVR sin FPU. En su lugar se usa una tabla de 1024
+ * entradas (una por cada valor del ADC de 10 bits) calculada en tiempo de
+ * compilación con constexpr y almacenada en PROGMEM, de modo que la
+ * conversión es una sola lectura de memoria de programa.
+ */
+
+#ifndef LIGHT_SENSOR_H
+#define LIGHT_SENSOR_H
+
+#include <Arduino.h>
+
+#ifndef RL10
+#define RL10 50 ///< Resistencia del LDR a 10 lux (kΩ)
+#endif
+
+#ifndef GAMMA
+#define GAMMA 0.7 ///< Pendiente log-log de la curva del LDR
+#endif
+
+const uint16_t LDR_SERIES_OHMS = 2000; ///< Resistencia del divisor junto al LDR (Ω)
+const uint16_t ADC_STEPS = 1024; ///< Pasos del ADC de 10 bits
+const uint16_t LUX_MAX = 65535; ///< Valor de saturación de la tabla
+
+/**
+ * @brief Convierte una lectura del ADC a lux.
+ *
+ * @param adc Valor de analogRead() (0–1023).
+ * @return uint16_t Lux redondeados, saturados en @c LUX_MAX.
+ */
+uint16_t luxFromAdc(uint16_t adc);
+
+/**
+ * @brief Lectura del ADC que corresponde a un nivel de luz.
+ *
+ * La curva es decreciente (más cuentas = menos luz), así que devuelve la
+ * primera cuenta cuyo valor en lux es menor o igual a @p lux.
+ */
+uint16_t adcForLux(uint16_t lux);
+
+/**
+ * @brief Umbrales de luz expresados en cuentas crudas del ADC.
+ *
+ * Los umbrales en lux se invierten una sola vez en begin() a límites en
+ * cuentas del ADC; las reglas de alarma de luz comparan contra ellos el
+ * valor de analogRead() con una comparación entera y aplican su propia
+ * histéresis.
+ */
+class LightThreshold {
+public:
+    /**
+     * @brief Nivel de luz según las reglas de alarma.
+     */
+    enum Level {
+        NORMAL, ///< Dentro del rango
+        ALTA, ///< Luz por encima del umbral alto
+        BAJA ///< Luz por debajo del umbral bajo
+    };
+
+    LightThreshold();
+
+    /**
+     * @brief Convierte los umbrales en lux a límites en cuentas del ADC.
+     *
+     * @param luxAlta Umbral de luz alta (alerta si lux > luxAlta).
+     * @param luxBaja Umbral de luz baja (alerta si lux < luxBaja).
+     */
+    void begin(uint16_t luxAlta, uint16_t luxBaja);
+
+    uint16_t adcAlta() const { return adcHigh; } ///< Cuentas por debajo de las cuales la luz es alta
+    uint16_t adcBaja() const { return adcLow; } ///< Cuentas por encima de las cuales la luz es baja
+
+private:
+    uint16_t adcHigh; ///< Luz alta si adc < adcHigh
+    uint16_t adcLow; ///< Luz baja si adc > adcLow
+};
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file Lockout.cpp
+ * @brief Implementación del bloqueo persistente.
+ */
+
+#include "Lockout.h"
+#include <EEPROM.h>
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+static uint8_t checksum(const LockoutRecord& r) {
+    return ~(uint8_t)(r.magic + r.failures + r.level + r.locked);
+}
+
+Lockout::Lockout(uint16_t eepromAddress, unsigned long baseMs)
+    : address(eepromAddress), baseMs(baseMs), startMs(0), writeOffset(0), writeLeft(0) {
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = MAGIC;
+}
+
+bool Lockout::begin() {
+    LockoutRecord r;
+    uint8_t* raw = (uint8_t*)&r;
+    for (uint8_t i = 0; i < RECORD_BYTES; i++) {
+        raw[i] = EEPROM.read(address + i);
+    }
+    if (r.magic != MAGIC) {
+        return false; ///< EEPROM virgen: sin intentos previos
+    }
+    if (r.check != checksum(r) || r.level > MAX_LEVEL) {
+        r.level = 1; ///< Escritura cortada a la mitad: no debe dar intentos nuevos
+        r.locked = 1;
+    }
+    rec = r;
+    if (rec.locked) {
+        start(); ///< Un corte de alimentación no acorta el bloqueo
+    }
+    return rec.locked;
+}
+
+bool Lockout::fail(uint8_t maxAttempts) {
+    if (rec.failures < 0xFF) rec.failures++;
+    if (rec.failures < maxAttempts) {
+        save();
+        return false;
+    }
+    if (rec.level < MAX_LEVEL) rec.level++;
+    rec.locked = 1;
+    start();
+    save();
+    return true;
+}
+
+void Lockout::succeed() {
+    if (!rec.failures && !rec.level && !rec.locked) {
+        return; ///< Nada que guardar
+    }
+    rec.failures = 0;
+    rec.level = 0;
+    rec.locked = 0;
+    save();
+}
+
+bool Lockout::locked() {
+    if (!rec.locked) {
+        return false;
+    }
+    if (millis() - startMs < windowMs()) {
+        return true;
+    }
+    rec.locked = 0;
+    rec.failures = 0; ///< Nueva serie de intentos; el nivel recuerda los bloqueos anteriores
+    save();
+    return false;
+}
+
+unsigned long Lockout::windowMs() const {
+    return rec.level ? baseMs << (rec.level - 1) : 0;
+}
+
+unsigned long Lockout::remainingMs() const {
+    if (!rec.locked) {
+        return 0;
+    }
+    unsigned long elapsed = millis() - startMs;
+    return elapsed < windowMs() ? windowMs() - elapsed : 0;
+}
+
+void Lockout::start() {
+    startMs = millis();
+}
+
+void Lockout::save() {
+    rec.check = checksum(rec);
+    memcpy(block, &rec, RECORD_BYTES);
+    writeOffset = 0;
+    writeLeft = RECORD_BYTES; ///< Un guardado en curso se reinicia con los datos nuevos
+}
+
+void Lockout::service() {
+    if (writeLeft == 0) {
+        return;
+    }
+#if defined(__AVR__)
+    if (!eeprom_is_ready()) return; ///< Escritura anterior en curso: no bloquear
+#endif
+    EEPROM.update(address + writeOffset, block[writeOffset]); ///< Solo escribe si cambió
+    writeOffset++;
+    writeLeft--;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file Lockout.h
+ * @brief Bloqueo por claves fallidas con ventanas que crecen al doble.
+ *
+ * Cada vez que se agotan los intentos el teclado se bloquea durante
+ * `baseMs · 2^(nivel - 1)`; el nivel sube con cada bloqueo y solo vuelve
+ * a cero con una clave correcta. Los intentos fallidos, el nivel y si hay
+ * un bloqueo en curso se guardan en la EEPROM, de modo que cortar la
+ * alimentación no da intentos nuevos: un bloqueo interrumpido se reinicia
+ * completo al arrancar (sin reloj de tiempo real no se sabe cuánto duró
+ * el corte). Guardar no bloquea: service() escribe de a un byte.
+ */
+
+#ifndef LOCKOUT_H
+#define LOCKOUT_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Registro del bloqueo en la EEPROM.
+ */
+struct __attribute__((packed)) LockoutRecord {
+    uint8_t magic; ///< `Lockout::MAGIC`
+    uint8_t failures; ///< Intentos fallidos desde la última clave correcta o bloqueo
+    uint8_t level; ///< Bloqueos seguidos sin una clave correcta
+    uint8_t locked; ///< 1 si había un bloqueo en curso
+    uint8_t check; ///< Complemento de la suma de los campos anteriores
+};
+
+/**
+ * @brief Contador de intentos y ventana de bloqueo persistentes.
+ */
+class Lockout {
+public:
+    static const uint8_t MAGIC = 0xB7;
+    static const uint8_t MAX_LEVEL = 8; ///< Tope de la duplicación: baseMs · 128
+    static const uint8_t RECORD_BYTES = sizeof(LockoutRecord); ///< Bytes en EEPROM
+
+    /**
+     * @param eepromAddress Dirección del registro.
+     * @param baseMs Duración del primer bloqueo.
+     */
+    Lockout(uint16_t eepromAddress, unsigned long baseMs);
+
+    /**
+     * @brief Carga el registro y retoma un bloqueo interrumpido.
+     *
+     * @return true si quedó bloqueado.
+     */
+    bool begin();
+
+    /**
+     * @brief Cuenta un intento fallido.
+     *
+     * @param maxAttempts Intentos permitidos antes de bloquear.
+     * @return true si el intento inició un bloqueo.
+     */
+    bool fail(uint8_t maxAttempts);
+
+    void succeed(); ///< Clave correcta: borra intentos y nivel
+
+    /**
+     * @brief Indica si la ventana sigue abierta.
+     *
+     * Al vencer la ventana borra los intentos (se conserva el nivel) y
+     * guarda el registro.
+     */
+    bool locked();
+
+    unsigned long remainingMs() const; ///< Tiempo que falta del bloqueo en curso
+    uint8_t failures() const { return rec.failures; } ///< Intentos fallidos acumulados
+    uint8_t level() const { return rec.level; } ///< Bloqueos seguidos
+    unsigned long windowMs() const; ///< Duración del bloqueo del nivel actual
+
+    /**
+     * @brief Avanza la escritura pendiente.
+     *
+     * Escribe como máximo un byte y solo si la EEPROM está libre.
+     */
+    void service();
+
+private:
+    void start(); ///< Abre la ventana del nivel actual
+    void save(); ///< Congela el registro para escribirlo
+
+    uint16_t address;
+    unsigned long baseMs;
+    LockoutRecord rec; ///< Copia en RAM
+    unsigned long startMs; ///< Apertura de la ventana en curso
+    uint8_t block[RECORD_BYTES]; ///< Registro en escritura
+    uint8_t writeOffset; ///< Próximo byte a escribir
+    uint8_t writeLeft; ///< Bytes que faltan por escribir
+};
+
+#endif
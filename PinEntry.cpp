@@ -0,0 +1,28 @@
+/**
+ * @file PinEntry.cpp
+ * @brief Implementación del ingreso de la clave.
+ */
+
+#include "PinEntry.h"
+
+bool PinEntry::add(char key) {
+    if (len >= LENGTH) {
+        return false;
+    }
+    digits[len++] = key;
+    digits[len] = '\0';
+    return true;
+}
+
+void PinEntry::clear() {
+    memset(digits, 0, sizeof(digits)); ///< No deja dígitos anteriores en RAM
+    len = 0;
+}
+
+bool PinEntry::matches(const char* secret) const {
+    uint8_t diff = len ^ LENGTH; ///< Distinto de 0 si la clave está incompleta
+    for (uint8_t i = 0; i < LENGTH; i++) { ///< Sin salida anticipada
+        diff |= digits[i] ^ pgm_read_byte(&secret[i]);
+    }
+    return diff == 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file PinEntry.h
+ * @brief Ingreso de la clave en un buffer de tamaño fijo.
+ *
+ * Sustituye el uso de String (que crece en el heap con cada tecla) por un
+ * arreglo de caracteres con su longitud. La comparación contra la clave
+ * guardada en PROGMEM recorre siempre todos los dígitos, para que el
+ * tiempo de respuesta no revele cuántos coinciden.
+ */
+
+#ifndef PIN_ENTRY_H
+#define PIN_ENTRY_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Clave en curso de captura.
+ */
+class PinEntry {
+public:
+    static const uint8_t LENGTH = 4; ///< Dígitos de la clave
+
+    PinEntry() { clear(); }
+
+    /**
+     * @brief Agrega un dígito si aún hay espacio.
+     *
+     * @return true si el dígito se agregó.
+     */
+    bool add(char key);
+
+    void clear(); ///< Borra la clave ingresada
+    uint8_t length() const { return len; } ///< Dígitos ingresados
+    bool full() const { return len == LENGTH; } ///< Indica si ya se ingresaron todos los dígitos
+
+    /**
+     * @brief Compara en tiempo constante contra una clave en PROGMEM.
+     *
+     * @param secret Clave de @c LENGTH caracteres almacenada en PROGMEM.
+     * @return true si la clave está completa y coincide.
+     */
+    bool matches(const char* secret) const;
+
+private:
+    char digits[LENGTH + 1]; ///< Dígitos ingresados, terminados en '\0'
+    uint8_t len; ///< Número de dígitos ingresados
+};
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file PinEvents.cpp
+ * @brief Implementación de la captura de flancos por PCINT.
+ */
+
+#include "PinEvents.h"
+#include "PowerManager.h"
+
+PinEvents pinEvents;
+
+PinEvents::PinEvents() : channelCount(0) {}
+
+int8_t PinEvents::addChannel(uint8_t pin, unsigned long debounceUs) {
+    if (channelCount >= MAX_CHANNELS) {
+        return -1;
+    }
+    Channel& c = channels[channelCount];
+    c.pin = pin;
+    c.mask = digitalPinToBitMask(pin);
+    c.input = portInputRegister(digitalPinToPort(pin));
+    c.debounceUs = debounceUs;
+    c.lastEdgeUs = 0;
+    c.level = (*c.input & c.mask) ? HIGH : LOW;
+    c.pending = false;
+    return channelCount++;
+}
+
+void PinEvents::begin() {
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+#endif
+    unsigned long now = micros();
+    for (uint8_t i = 0; i < channelCount; i++) {
+        channels[i].lastEdgeUs = now; ///< El primer pulso se mide desde aquí
+    }
+#if defined(__AVR__)
+    for (uint8_t i = 0; i < channelCount; i++) {
+        uint8_t pin = channels[i].pin;
+        *digitalPinToPCMSK(pin) |= bit(digitalPinToPCMSKbit(pin)); ///< Habilita el pin en su grupo
+        PCIFR |= bit(digitalPinToPCICRbit(pin)); ///< Descarta un cambio previo pendiente
+        *digitalPinToPCICR(pin) |= bit(digitalPinToPCICRbit(pin)); ///< Habilita el grupo
+    }
+    SREG = oldSREG;
+#endif
+}
+
+void PinEvents::handleChange() {
+    unsigned long now = micros();
+    for (uint8_t i = 0; i < channelCount; i++) {
+        Channel& c = channels[i];
+        uint8_t level = (*c.input & c.mask) ? HIGH : LOW;
+        if (level == c.level) continue; ///< El cambio fue de otro pin del grupo
+        if (now - c.lastEdgeUs < c.debounceUs) { ///< Rebote dentro de la ventana
+            c.pending = true; ///< settle() confirma el nivel al vencer la ventana
+            continue;
+        }
+        accept(i, level, now);
+    }
+}
+
+void PinEvents::settle() {
+    for (uint8_t i = 0; i < channelCount; i++) {
+#if defined(__AVR__)
+        uint8_t oldSREG = SREG;
+        cli(); ///< La ISR no debe aceptar un flanco entre la lectura y el encolado
+#endif
+        Channel& c = channels[i];
+        unsigned long now = micros();
+        if (c.pending && now - c.lastEdgeUs >= c.debounceUs) {
+            c.pending = false;
+            uint8_t level = (*c.input & c.mask) ? HIGH : LOW;
+            if (level != c.level) accept(i, level, now); ///< El flanco de cierre cayó dentro de la ventana
+        }
+#if defined(__AVR__)
+        SREG = oldSREG;
+#endif
+    }
+}
+
+void PinEvents::accept(uint8_t channel, uint8_t level, unsigned long now) {
+    Channel& c = channels[channel];
+    PinEvent e = {channel, level, now, now - c.lastEdgeUs};
+    c.level = level;
+    c.lastEdgeUs = now;
+    c.pending = false;
+    queue.push(e);
+    PowerManager::requestWake(); ///< El bucle debe atender el evento cuanto antes
+}
+
+#if defined(__AVR__)
+// Todas las ISR de cambio de pin revisan los canales registrados; solo se
+// disparan las de los grupos habilitados en begin().
+ISR(PCINT0_vect) { pinEvents.handleChange(); }
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect) { pinEvents.handleChange(); }
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect) { pinEvents.handleChange(); }
+#endif
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file PinEvents.h
+ * @brief Captura por interrupción de flancos en entradas digitales.
+ *
+ * Los sensores infrarrojo y Hall entregan pulsos que se pierden si se
+ * consultan con digitalRead() desde el bucle. Aquí cada canal usa la
+ * interrupción por cambio de pin (PCINT): la ISR lee el nivel, aplica una
+ * ventana antirrebote por canal y guarda el evento con su marca de tiempo
+ * en una cola sin bloqueo que el bucle principal vacía cuando puede.
+ *
+ * Cada evento lleva además la duración del nivel que terminó, medida en
+ * la ISR, de modo que el ancho de cada pulso se conoce con la resolución
+ * de micros() (4 µs) aunque el bucle atienda la cola mucho después.
+ *
+ * Un flanco que llega dentro de la ventana antirrebote no se encola, pero
+ * el canal queda pendiente: settle() vuelve a leer el pin al vencer la
+ * ventana y encola el nivel si difiere del aceptado. Así un pulso más
+ * corto que la ventana no deja el canal trabado en el nivel equivocado.
+ */
+
+#ifndef PIN_EVENTS_H
+#define PIN_EVENTS_H
+
+#include <Arduino.h>
+#include "RingBuffer.h"
+
+/**
+ * @brief Flanco detectado en un canal.
+ */
+struct PinEvent {
+    uint8_t channel; ///< Canal que cambió
+    uint8_t level; ///< Nivel nuevo (HIGH o LOW)
+    unsigned long timeUs; ///< Instante del flanco (micros)
+    unsigned long durationUs; ///< Duración del nivel anterior (en un flanco de bajada, el ancho del pulso)
+};
+
+/**
+ * @brief Gestor de canales con interrupción por cambio de pin.
+ */
+class PinEvents {
+public:
+    static const uint8_t MAX_CHANNELS = 4; ///< Canales máximos
+    static const uint8_t QUEUE_SIZE = 16; ///< Posiciones de la cola de eventos
+
+    PinEvents();
+
+    /**
+     * @brief Registra un pin como canal de eventos.
+     *
+     * @param pin Pin digital con soporte PCINT.
+     * @param debounceUs Tiempo mínimo entre flancos aceptados.
+     * @return int8_t Identificador del canal o -1 si no hay espacio.
+     */
+    int8_t addChannel(uint8_t pin, unsigned long debounceUs);
+
+    void begin(); ///< Habilita las interrupciones de los canales registrados y arranca la medición
+
+    /**
+     * @brief Extrae el evento más antiguo de la cola.
+     *
+     * @return false si no hay eventos pendientes.
+     */
+    bool pop(PinEvent& event) { return queue.pop(event); }
+
+    /**
+     * @brief Revisa todos los canales y encola los flancos nuevos.
+     *
+     * Se llama desde la ISR de cambio de pin; también puede llamarse
+     * desde el bucle en plataformas sin PCINT.
+     */
+    void handleChange();
+
+    /**
+     * @brief Confirma el nivel de los canales con un flanco descartado.
+     *
+     * Se llama periódicamente desde el bucle. Si venció la ventana
+     * antirrebote y el pin quedó en un nivel distinto del aceptado, encola
+     * el flanco con el instante de la lectura.
+     */
+    void settle();
+
+    uint8_t level(uint8_t channel) const { return channels[channel].level; } ///< Último nivel aceptado
+    uint16_t overflows() const { return queue.overflows(); } ///< Eventos perdidos por cola llena
+
+private:
+    void accept(uint8_t channel, uint8_t level, unsigned long now); ///< Encola un flanco aceptado
+
+    /**
+     * @brief Estado de un canal.
+     */
+    struct Channel {
+        uint8_t pin; ///< Pin digital
+        uint8_t mask; ///< Máscara del bit en el registro de entrada
+        volatile uint8_t* input; ///< Registro de entrada del puerto
+        unsigned long debounceUs; ///< Ventana antirrebote
+        unsigned long lastEdgeUs; ///< Instante del último flanco aceptado
+        uint8_t level; ///< Último nivel aceptado
+        bool pending; ///< Hubo un flanco descartado por la ventana antirrebote
+    };
+
+    Channel channels[MAX_CHANNELS]; ///< Canales registrados
+    uint8_t channelCount; ///< Número de canales
+    RingBuffer<PinEvent, QUEUE_SIZE> queue; ///< Cola ISR → bucle principal
+};
+
+extern PinEvents pinEvents; ///< Eventos de los sensores infrarrojo y Hall
+
+#endif
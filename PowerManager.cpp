@@ -0,0 +1,67 @@
+/**
+ * @file PowerManager.cpp
+ * @brief Implementación del modo de reposo.
+ */
+
+#include "PowerManager.h"
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+volatile bool PowerManager::wakeRequested = false;
+
+PowerManager::PowerManager(unsigned long wakePeriodMs)
+    : wakePeriodMs(wakePeriodMs), idleTotalMs(0), idleRemainderUs(0), sleepCount(0) {}
+
+void PowerManager::idle(unsigned long ms) {
+    if (ms == 0) {
+        return;
+    }
+    if (ms > wakePeriodMs) {
+        ms = wakePeriodMs;
+    }
+
+    unsigned long startMs = millis();
+    unsigned long startUs = micros();
+    sleepCount++;
+
+#if defined(__AVR__)
+    set_sleep_mode(SLEEP_MODE_IDLE); ///< Los timers siguen activos: millis() no se detiene
+    while (millis() - startMs < ms) {
+        cli();
+        if (wakeRequested) { ///< Se revisa con interrupciones deshabilitadas para no perder el aviso
+            sei();
+            break;
+        }
+        sleep_enable();
+        sei(); ///< sleep_cpu() se ejecuta antes de atender cualquier interrupción pendiente
+        sleep_cpu();
+        sleep_disable();
+    }
+#else
+    (void)startMs;
+#endif
+    wakeRequested = false;
+    accountIdle(micros() - startUs);
+}
+
+void PowerManager::accountIdle(unsigned long us) {
+    idleRemainderUs += us;
+    idleTotalMs += idleRemainderUs / 1000;
+    idleRemainderUs %= 1000;
+}
+
+uint8_t PowerManager::idlePercent() const {
+    unsigned long uptime = millis();
+    if (uptime < 100) {
+        return 0;
+    }
+    unsigned long pct = idleTotalMs / (uptime / 100); ///< Sin desbordar idleTotalMs * 100
+    return pct > 100 ? 100 : pct;
+}
+
+float PowerManager::estimatedMah() const {
+    unsigned long awake = millis() - idleTotalMs;
+    return (awake * (float)ACTIVE_MA + idleTotalMs * (float)IDLE_MA) / 3600000.0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file PowerManager.h
+ * @brief Modo de bajo consumo entre ticks del planificador.
+ *
+ * Cuando no hay tareas vencidas, el bucle principal duerme el AVR en
+ * SLEEP_MODE_IDLE: la CPU se detiene pero los timers, el ADC, la UART y
+ * las interrupciones por cambio de pin siguen activos, así que millis()
+ * avanza y cualquier interrupción despierta al sistema. El módulo lleva la
+ * cuenta del tiempo dormido para estimar el ahorro de cada unidad; el
+ * menú de diagnóstico y el bus publican el porcentaje en reposo y la carga
+ * estimada.
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Gestor del modo de reposo.
+ */
+class PowerManager {
+public:
+    static const uint8_t ACTIVE_MA = 22; ///< Consumo estimado del AVR activo a 16 MHz (mA)
+    static const uint8_t IDLE_MA = 9; ///< Consumo estimado del AVR en reposo (mA)
+
+    /**
+     * @param wakePeriodMs Tiempo máximo que se duerme sin volver al bucle.
+     */
+    explicit PowerManager(unsigned long wakePeriodMs);
+
+    /**
+     * @brief Duerme hasta @p ms milisegundos o hasta que se pida despertar.
+     *
+     * El Timer0 despierta a la CPU cada ~1 ms; tras cada despertar se
+     * revisa si ya se cumplió el plazo, si pasó el periodo de despertar o
+     * si una interrupción llamó a requestWake(). Con @p ms igual a 0
+     * retorna de inmediato.
+     */
+    void idle(unsigned long ms);
+
+    /**
+     * @brief Pide salir del reposo en el próximo despertar.
+     *
+     * Lo llaman las ISR que dejan trabajo pendiente para el bucle.
+     */
+    static void requestWake() { wakeRequested = true; }
+
+    /**
+     * @brief Suma tiempo en reposo medido fuera de idle().
+     *
+     * idle() la usa con lo que durmió; el simulador de escritorio, que
+     * avanza el reloj fuera del bucle, la llama con el tiempo saltado.
+     */
+    void accountIdle(unsigned long us);
+
+    unsigned long wakePeriod() const { return wakePeriodMs; } ///< Periodo máximo de reposo
+    void setWakePeriod(unsigned long ms) { wakePeriodMs = ms; } ///< Cambia el periodo máximo de reposo
+    unsigned long uptimeMs() const { return millis(); } ///< Tiempo encendido
+    unsigned long idleMs() const { return idleTotalMs; } ///< Tiempo acumulado en reposo
+    unsigned long sleeps() const { return sleepCount; } ///< Veces que se entró en reposo
+    uint8_t idlePercent() const; ///< Porcentaje del tiempo encendido pasado en reposo
+
+    /**
+     * @brief Carga consumida estimada desde el arranque.
+     *
+     * @return float Miliamperios-hora según @c ACTIVE_MA e @c IDLE_MA.
+     */
+    float estimatedMah() const;
+
+private:
+    static volatile bool wakeRequested; ///< Lo activan las ISR con trabajo pendiente
+
+    unsigned long wakePeriodMs; ///< Tiempo máximo de reposo continuo
+    unsigned long idleTotalMs; ///< Reposo acumulado en ms
+    unsigned long idleRemainderUs; ///< Fracción de ms aún no sumada
+    unsigned long sleepCount; ///< Veces que se entró en reposo
+};
+
+extern PowerManager power; ///< Gestor de reposo del sistema
+
+#endif
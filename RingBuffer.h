@@ -0,0 +1,77 @@
+/**
+ * @file RingBuffer.h
+ * @brief Cola circular sin bloqueo para un productor y un consumidor.
+ *
+ * Pensada para pasar datos de una interrupción al bucle principal (o al
+ * revés). Cada lado solo escribe su propio índice y los índices son de 8
+ * bits, cuya lectura y escritura es atómica en AVR, por lo que no hace
+ * falta deshabilitar interrupciones.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Cola circular SPSC de capacidad fija.
+ *
+ * @tparam T Tipo de elemento.
+ * @tparam N Número de posiciones (potencia de 2, máximo 128). La cola
+ *           guarda hasta N - 1 elementos.
+ */
+template <typename T, uint8_t N>
+class RingBuffer {
+public:
+    RingBuffer() : head(0), tail(0), dropped(0) {}
+
+    /**
+     * @brief Agrega un elemento (lado productor).
+     *
+     * @return false si la cola estaba llena; el elemento se descarta.
+     */
+    bool push(const T& item) {
+        uint8_t h = head;
+        uint8_t next = (h + 1) & (N - 1);
+        if (next == tail) {
+            dropped++;
+            return false;
+        }
+        buffer[h] = item;
+        __asm__ __volatile__("" ::: "memory"); ///< Evita que el compilador reordene el dato tras el índice
+        head = next; ///< Se publica después de escribir el dato
+        return true;
+    }
+
+    /**
+     * @brief Extrae el elemento más antiguo (lado consumidor).
+     *
+     * @return false si la cola estaba vacía.
+     */
+    bool pop(T& item) {
+        uint8_t t = tail;
+        if (t == head) {
+            return false;
+        }
+        item = buffer[t];
+        __asm__ __volatile__("" ::: "memory");
+        tail = (t + 1) & (N - 1); ///< Se libera después de leer el dato
+        return true;
+    }
+
+    bool empty() const { return head == tail; } ///< Indica si la cola está vacía
+    uint8_t size() const { return (head - tail) & (N - 1); } ///< Elementos en la cola
+    uint8_t capacity() const { return N - 1; } ///< Elementos que caben en la cola
+    uint16_t overflows() const { return dropped; } ///< Elementos descartados por cola llena
+    void clear() { tail = head; } ///< Vacía la cola (lado consumidor)
+
+private:
+    static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "N debe ser potencia de 2 entre 2 y 128");
+
+    T buffer[N]; ///< Almacenamiento
+    volatile uint8_t head; ///< Próxima posición a escribir (productor)
+    volatile uint8_t tail; ///< Próxima posición a leer (consumidor)
+    volatile uint16_t dropped; ///< Elementos descartados (productor)
+};
+
+#endif
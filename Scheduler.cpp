@@ -0,0 +1,94 @@
+/**
+ * @file Scheduler.cpp
+ * @brief Implementación del planificador cooperativo.
+ */
+
+#include "Scheduler.h"
+
+Scheduler scheduler;
+
+Scheduler::Scheduler() : taskCount(0), runningId(-1) {}
+
+int8_t Scheduler::addTask(TaskFn fn, unsigned long periodMs, const char* name, unsigned long budgetUs) {
+    if (taskCount >= MAX_TASKS) { ///< Sin espacio en la tabla
+        return -1;
+    }
+    Task& t = tasks[taskCount];
+    t.fn = fn;
+    t.name = name;
+    t.periodMs = periodMs;
+    t.deadline = millis() + periodMs;
+    t.budgetUs = budgetUs;
+    t.maxRunUs = 0;
+    t.overruns = 0;
+    t.lastRunMs = millis();
+    t.armed = periodMs != 0; ///< Las tareas de un solo disparo inician desarmadas
+    return taskCount++;
+}
+
+void Scheduler::schedule(int8_t id, unsigned long delayMs) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].deadline = millis() + delayMs;
+    tasks[id].armed = true;
+}
+
+void Scheduler::cancel(int8_t id) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].armed = false;
+}
+
+bool Scheduler::isArmed(int8_t id) const {
+    return id >= 0 && id < taskCount && tasks[id].armed;
+}
+
+void Scheduler::setPeriod(int8_t id, unsigned long periodMs) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].periodMs = periodMs;
+}
+
+void Scheduler::run() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        Task& t = tasks[i];
+        if (!t.armed) continue;
+        unsigned long now = millis();
+        if ((long)(now - t.deadline) < 0) continue; ///< Aún no vence (seguro ante desborde)
+
+        if (t.periodMs == 0) {
+            t.armed = false; ///< Un solo disparo: se desarma antes de ejecutar
+        } else {
+            t.deadline += t.periodMs;
+            if ((long)(now - t.deadline) >= 0) {
+                t.deadline = now + t.periodMs; ///< Se perdieron periodos: se re-sincroniza
+            }
+        }
+
+        unsigned long start = micros();
+        runningId = i;
+        t.fn();
+        runningId = -1;
+        t.lastRunMs = millis();
+        unsigned long elapsed = micros() - start;
+        if (elapsed > t.maxRunUs) t.maxRunUs = elapsed;
+        if (elapsed > t.budgetUs) t.overruns++;
+    }
+}
+
+unsigned long Scheduler::msUntilNext(unsigned long limit) const {
+    unsigned long now = millis();
+    unsigned long best = limit;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const Task& t = tasks[i];
+        if (!t.armed) continue;
+        long remaining = (long)(t.deadline - now);
+        if (remaining <= 0) return 0;
+        if ((unsigned long)remaining < best) best = remaining;
+    }
+    return best;
+}
+
+void Scheduler::resetStats() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        tasks[i].maxRunUs = 0;
+        tasks[i].overruns = 0;
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file Scheduler.h
+ * @brief Planificador cooperativo de tareas basado en millis().
+ *
+ * Reemplaza las esperas con delay() por tareas periódicas y de un solo
+ * disparo (one-shot) que se ejecutan desde loop(). Cada tarea debe ser
+ * corta y retornar rápido; el planificador mide cuánto tarda cada una y
+ * guarda el máximo para detectar las que exceden su presupuesto.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+typedef void (*TaskFn)(); ///< Firma de una tarea del planificador
+
+/**
+ * @brief Planificador cooperativo de capacidad fija.
+ *
+ * Las tareas se registran una sola vez en setup(). Una tarea con periodo
+ * 0 es de un solo disparo: queda desarmada hasta que se llama a
+ * schedule(), se ejecuta una vez al vencer su plazo y vuelve a desarmarse.
+ */
+class Scheduler {
+public:
+    static const uint8_t MAX_TASKS = 16; ///< Número máximo de tareas registradas
+
+    /**
+     * @brief Estadísticas y configuración de una tarea.
+     */
+    struct Task {
+        TaskFn fn; ///< Función a ejecutar
+        const char* name; ///< Nombre para diagnóstico
+        unsigned long periodMs; ///< Periodo en ms (0 = un solo disparo)
+        unsigned long deadline; ///< Próximo instante de ejecución (millis)
+        unsigned long budgetUs; ///< Presupuesto de tiempo por ejecución
+        unsigned long maxRunUs; ///< Tiempo máximo observado por ejecución
+        unsigned int overruns; ///< Veces que se excedió el presupuesto
+        unsigned long lastRunMs; ///< Fin de la última ejecución: el latido que vigila el watchdog
+        bool armed; ///< Indica si la tarea está pendiente
+    };
+
+    Scheduler();
+
+    /**
+     * @brief Registra una tarea.
+     *
+     * @param fn Función a ejecutar.
+     * @param periodMs Periodo en ms; 0 crea una tarea de un solo disparo.
+     * @param name Nombre para diagnóstico.
+     * @param budgetUs Presupuesto de tiempo por ejecución en µs.
+     * @return int8_t Identificador de la tarea o -1 si no hay espacio.
+     */
+    int8_t addTask(TaskFn fn, unsigned long periodMs, const char* name, unsigned long budgetUs = 1000);
+
+    /**
+     * @brief Arma una tarea para que se ejecute dentro de @p delayMs ms.
+     *
+     * En tareas periódicas reinicia la fase del periodo.
+     */
+    void schedule(int8_t id, unsigned long delayMs);
+
+    void cancel(int8_t id); ///< Desarma una tarea
+    bool isArmed(int8_t id) const; ///< Indica si la tarea está pendiente
+    void setPeriod(int8_t id, unsigned long periodMs); ///< Cambia el periodo de una tarea
+
+    /**
+     * @brief Ejecuta todas las tareas cuyo plazo ya venció.
+     *
+     * Se llama desde loop() en cada iteración.
+     */
+    void run();
+
+    /**
+     * @brief Milisegundos que faltan para el próximo plazo.
+     *
+     * @return unsigned long 0 si hay tareas vencidas; @p limit si no hay
+     *         ninguna tarea armada antes de ese límite.
+     */
+    unsigned long msUntilNext(unsigned long limit) const;
+
+    const Task& task(int8_t id) const { return tasks[id]; } ///< Acceso de solo lectura a una tarea
+    uint8_t count() const { return taskCount; } ///< Número de tareas registradas
+    int8_t running() const { return runningId; } ///< Tarea en ejecución (-1 fuera de run())
+    void resetStats(); ///< Reinicia los contadores de tiempo máximo y excesos
+
+private:
+    Task tasks[MAX_TASKS]; ///< Tabla de tareas
+    uint8_t taskCount; ///< Número de tareas registradas
+    volatile int8_t runningId; ///< Lo lee la ISR del watchdog
+};
+
+extern Scheduler scheduler; ///< Planificador global del sistema
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file SensorBus.cpp
+ * @brief Implementación del nodo Modbus-RTU.
+ */
+
+#include "SensorBus.h"
+
+SensorBus bus;
+
+static const uint8_t FN_READ_HOLDING = 0x03; ///< Leer registros de retención
+static const uint8_t FN_READ_INPUT = 0x04; ///< Leer registros de entrada
+static const uint8_t EX_ILLEGAL_FUNCTION = 0x01; ///< Función no soportada
+static const uint8_t EX_ILLEGAL_ADDRESS = 0x02; ///< Registros fuera del mapa
+static const uint8_t EX_ILLEGAL_VALUE = 0x03; ///< Cantidad inválida
+static const uint8_t REQUEST_BYTES = 8; ///< Dirección, función, inicio, cantidad y CRC
+static const uint8_t RESPONSE_BYTES = 5 + 2 * SensorBus::REG_COUNT; ///< Respuesta con el mapa completo
+static_assert(RESPONSE_BYTES <= SensorBus::MAX_FRAME, "El maestro no puede recibir el mapa completo");
+
+SensorBus::SensorBus()
+    : charUs(0), silenceUs(0), dePin(0), address(0), fill(nullptr), length(0), overflow(false), lastRxUs(0),
+      transmitting(false), txDoneUs(0), servedCount(0), crcCount(0), table(nullptr), nodes(0), polled(0),
+      awaiting(false), pollStartMs(0), pollPeriodMs(0) {}
+
+void SensorBus::begin(unsigned long baud, uint8_t de, uint8_t addr, FillFn fn) {
+    dePin = de;
+    address = addr;
+    fill = fn;
+    charUs = 11000000UL / baud; ///< 8E1: 11 bits por carácter
+    silenceUs = baud > 19200 ? 1750 : charUs * 7 / 2; ///< Valor fijo de la norma por encima de 19200
+    pinMode(dePin, OUTPUT);
+    digitalWrite(dePin, LOW); ///< Receptor habilitado
+    Serial1.begin(baud, SERIAL_8E1);
+}
+
+void SensorBus::beginMaster(Node* nodeTable, uint8_t count, unsigned long periodMs) {
+    table = nodeTable;
+    nodes = count;
+    polled = 0;
+    awaiting = false;
+    pollPeriodMs = periodMs;
+    pollStartMs = millis() - periodMs; ///< La primera consulta sale en el próximo update()
+    memset(table, 0, sizeof(Node) * count);
+}
+
+void SensorBus::update() {
+#if !defined(__AVR__)
+    if (transmitting && (long)(micros() - txDoneUs) >= 0) {
+        onTxComplete(); ///< En el host no hay interrupción de fin de transmisión
+    }
+#endif
+    while (Serial1.available() > 0) { ///< Los bytes ya los recibió la ISR de HardwareSerial
+        uint8_t c = Serial1.read();
+        if (length < MAX_FRAME) {
+            frame[length++] = c;
+        } else {
+            overflow = true;
+        }
+        lastRxUs = micros();
+    }
+    if ((length || overflow) && micros() - lastRxUs >= silenceUs) { ///< Silencio: la trama terminó
+        if (!overflow) {
+            handleFrame();
+        }
+        length = 0;
+        overflow = false;
+    }
+
+    if (!table || transmitting) {
+        return;
+    }
+    if (awaiting) {
+        if (millis() - pollStartMs < RESPONSE_TIMEOUT_MS) {
+            return;
+        }
+        Node& n = table[polled]; ///< Sin respuesta
+        if (n.misses < 0xFF) n.misses++;
+        if (n.misses >= OFFLINE_MISSES) n.online = false;
+        awaiting = false;
+        polled = polled + 1 < nodes ? polled + 1 : 0;
+    }
+    if (millis() - pollStartMs >= pollPeriodMs) {
+        sendPoll();
+    }
+}
+
+void SensorBus::onTxComplete() {
+#if defined(__AVR__) && defined(UCSR1B)
+    if (UCSR1B & bit(UDRIE1)) {
+        return; ///< Quedan bytes en el buffer de HardwareSerial
+    }
+    UCSR1B &= ~bit(TXCIE1);
+#endif
+    digitalWrite(dePin, LOW); ///< Devuelve el bus
+    transmitting = false;
+}
+
+uint16_t SensorBus::crc16(const uint8_t* data, uint8_t len) {
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+void SensorBus::handleFrame() {
+    if (length < 4) {
+        return; ///< Ruido
+    }
+    uint16_t crc = crc16(frame, length - 2);
+    if (frame[length - 2] != (crc & 0xFF) || frame[length - 1] != (crc >> 8)) {
+        crcCount++;
+        return;
+    }
+    if (awaiting && frame[0] == polled + 1) {
+        handleResponse();
+    } else if (frame[0] == address) {
+        handleRequest(); ///< Las tramas de otras unidades se ignoran
+    }
+}
+
+void SensorBus::handleRequest() {
+    uint8_t function = frame[1];
+    if (function != FN_READ_HOLDING && function != FN_READ_INPUT) {
+        sendException(function, EX_ILLEGAL_FUNCTION);
+        return;
+    }
+    if (length != REQUEST_BYTES) {
+        sendException(function, EX_ILLEGAL_VALUE);
+        return;
+    }
+    uint16_t start = ((uint16_t)frame[2] << 8) | frame[3];
+    uint16_t count = ((uint16_t)frame[4] << 8) | frame[5];
+    if (count == 0 || count > REG_COUNT) {
+        sendException(function, EX_ILLEGAL_VALUE);
+        return;
+    }
+    if (start + count > REG_COUNT) {
+        sendException(function, EX_ILLEGAL_ADDRESS);
+        return;
+    }
+
+    uint16_t regs[REG_COUNT];
+    fill(regs); ///< Solo copia cachés: no bloquea
+    frame[2] = count * 2;
+    for (uint8_t i = 0; i < count; i++) {
+        frame[3 + 2 * i] = regs[start + i] >> 8; ///< Big endian, como manda Modbus
+        frame[4 + 2 * i] = regs[start + i] & 0xFF;
+    }
+    transmit(3 + 2 * count);
+}
+
+void SensorBus::handleResponse() {
+    Node& n = table[polled];
+    if (frame[1] == FN_READ_INPUT && length == RESPONSE_BYTES && frame[2] == 2 * REG_COUNT) {
+        for (uint8_t i = 0; i < REG_COUNT; i++) {
+            n.regs[i] = ((uint16_t)frame[3 + 2 * i] << 8) | frame[4 + 2 * i];
+        }
+        n.lastSeenMs = millis();
+        n.misses = 0;
+        n.online = true;
+    } else { ///< Excepción o respuesta inesperada
+        if (n.misses < 0xFF) n.misses++;
+        if (n.misses >= OFFLINE_MISSES) n.online = false;
+    }
+    awaiting = false;
+    polled = polled + 1 < nodes ? polled + 1 : 0;
+}
+
+void SensorBus::sendPoll() {
+    pollStartMs = millis();
+    if (polled + 1 == address) { ///< La propia unidad no pasa por el bus
+        Node& n = table[polled];
+        fill(n.regs);
+        n.lastSeenMs = pollStartMs;
+        n.misses = 0;
+        n.online = true;
+        polled = polled + 1 < nodes ? polled + 1 : 0;
+        return;
+    }
+    frame[0] = polled + 1;
+    frame[1] = FN_READ_INPUT;
+    frame[2] = 0;
+    frame[3] = 0;
+    frame[4] = 0;
+    frame[5] = REG_COUNT;
+    transmit(6);
+    awaiting = true;
+}
+
+void SensorBus::sendException(uint8_t function, uint8_t code) {
+    frame[1] = function | 0x80;
+    frame[2] = code;
+    transmit(3);
+}
+
+void SensorBus::transmit(uint8_t len) {
+    uint16_t crc = crc16(frame, len);
+    frame[len++] = crc & 0xFF; ///< El CRC va con el byte bajo primero
+    frame[len++] = crc >> 8;
+    if (Serial1.availableForWrite() < len) {
+        return; ///< No debería pasar: la trama más larga cabe en el buffer vacío
+    }
+    digitalWrite(dePin, HIGH); ///< Toma el bus
+    transmitting = true;
+    Serial1.write(frame, len);
+    if (frame[0] == address) servedCount++;
+#if defined(__AVR__) && defined(UCSR1B)
+    UCSR1B |= bit(TXCIE1); ///< Avisa cuando sale el último bit
+#else
+    txDoneUs = micros() + len * charUs;
+#endif
+}
+
+#if defined(__AVR__) && defined(USART1_TX_vect)
+ISR(USART1_TX_vect) {
+    bus.onTxComplete();
+}
+#endif
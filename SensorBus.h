@@ -0,0 +1,151 @@
+/**
+ * @file SensorBus.h
+ * @brief Bus de sensores Modbus-RTU sobre RS-485 entre varias unidades.
+ *
+ * Cada unidad es un esclavo que publica sus últimas muestras en un mapa de
+ * registros de entrada (funciones 03 y 04, ambas leen el mismo mapa). Una
+ * unidad compilada con -DBUS_MASTER además consulta a las demás por turno y
+ * guarda una copia de sus registros.
+ *
+ * El bus usa Serial1 (USART1, pines 18 y 19 del Mega) y un pin de
+ * habilitación del transmisor (DE/RE del MAX485). La recepción la hace la
+ * ISR de HardwareSerial; update() solo copia bytes del buffer, delimita la
+ * trama por silencio (3,5 caracteres) y responde con los registros que
+ * llena la función del sketch a partir de las cachés, sin leer sensores.
+ * La respuesta entera cabe en el buffer de transmisión, de modo que
+ * enviarla nunca bloquea, y la ISR de fin de transmisión libera el bus.
+ */
+
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Nodo Modbus-RTU (esclavo y, opcionalmente, maestro).
+ */
+class SensorBus {
+public:
+    /**
+     * @brief Mapa de registros de entrada de cada unidad.
+     */
+    enum Register : uint8_t {
+        REG_STATUS, ///< Bits `StatusBit`
+        REG_STATE, ///< Estado de la máquina de estados
+        REG_TEMP, ///< Temperatura filtrada (centésimas de °C, con signo)
+        REG_HUM, ///< Humedad filtrada (centésimas de %)
+        REG_LIGHT, ///< Luz filtrada (cuentas de 10 bits)
+        REG_LUX, ///< Luz filtrada en lux
+        REG_UPTIME_HI, ///< Segundos desde el arranque (parte alta)
+        REG_UPTIME_LO, ///< Segundos desde el arranque (parte baja)
+        REG_IR_EVENTS, ///< Flancos infrarrojos desde el arranque
+        REG_HALL_EVENTS, ///< Flancos Hall desde el arranque
+        REG_DHT_FAILURES, ///< Lecturas fallidas del DHT
+        REG_LOOP_MAX_US, ///< Peor iteración de loop() (µs, saturado)
+        REG_IDLE_PCT, ///< Porcentaje del tiempo encendido en reposo
+        REG_MAH, ///< Carga consumida estimada desde el arranque (mAh, saturado)
+        REG_COUNT ///< Número de registros
+    };
+
+    /**
+     * @brief Bits de `REG_STATUS`.
+     */
+    enum StatusBit : uint16_t {
+        ST_DHT_VALID = 1, ///< Hay una muestra válida reciente del DHT
+        ST_IR = 2, ///< Nivel actual del sensor infrarrojo
+        ST_HALL = 4, ///< Nivel actual del sensor Hall
+        ST_LIGHT_ALERT = 8, ///< Luz fuera de rango
+        ST_ALARM = 16, ///< Alarma crítica de temperatura o humedad
+        ST_SILENCED = 32 ///< Alarma silenciada por el operador
+    };
+
+    /**
+     * @brief Copia de los registros de una unidad consultada por el maestro.
+     */
+    struct Node {
+        uint16_t regs[REG_COUNT]; ///< Última respuesta válida
+        unsigned long lastSeenMs; ///< Tiempo de la última respuesta válida
+        uint8_t misses; ///< Consultas seguidas sin respuesta válida
+        bool online; ///< Respondió desde la última serie de fallas
+    };
+
+    typedef void (*FillFn)(uint16_t* regs); ///< Llena `REG_COUNT` registros desde las cachés
+
+    static const uint8_t MAX_FRAME = 36; ///< Trama más larga que se acepta (la respuesta ocupa 33)
+    static const uint8_t OFFLINE_MISSES = 3; ///< Fallas seguidas para dar un nodo por perdido
+    static const unsigned long RESPONSE_TIMEOUT_MS = 50; ///< Espera del maestro por una respuesta
+
+    SensorBus();
+
+    /**
+     * @brief Inicia la unidad como esclavo.
+     *
+     * @param baud Velocidad de Serial1.
+     * @param dePin Pin DE/RE del transceptor RS-485.
+     * @param address Dirección Modbus (1–247).
+     * @param fill Función que llena los registros al responder.
+     */
+    void begin(unsigned long baud, uint8_t dePin, uint8_t address, FillFn fill);
+
+    /**
+     * @brief Además consulta por turno a las unidades 1..count.
+     *
+     * Envía una consulta cada @p periodMs ms, así que cada unidad se
+     * refresca cada count · periodMs ms. La entrada de la propia dirección
+     * se llena sin pasar por el bus. @p nodeTable pertenece al sketch.
+     */
+    void beginMaster(Node* nodeTable, uint8_t count, unsigned long periodMs);
+
+    /**
+     * @brief Atiende el bus; se llama desde una tarea cada ~1 ms.
+     */
+    void update();
+
+    /**
+     * @brief Fin de la transmisión: libera el bus (la llama la ISR).
+     */
+    void onTxComplete();
+
+    unsigned int served() const { return servedCount; } ///< Respuestas enviadas
+    unsigned int crcErrors() const { return crcCount; } ///< Tramas descartadas por CRC
+    uint8_t nodeCount() const { return nodes; } ///< Unidades consultadas (solo maestro)
+    const Node& node(uint8_t i) const { return table[i]; } ///< Copia de la unidad i + 1
+
+    /**
+     * @brief CRC-16/MODBUS (polinomio 0xA001 reflejado, inicio 0xFFFF).
+     */
+    static uint16_t crc16(const uint8_t* data, uint8_t len);
+
+private:
+    void handleFrame();
+    void handleRequest();
+    void handleResponse();
+    void sendPoll();
+    void transmit(uint8_t len);
+    void sendException(uint8_t function, uint8_t code);
+
+    unsigned long charUs; ///< Duración de un carácter (11 bits)
+    unsigned long silenceUs; ///< Silencio que cierra una trama (3,5 caracteres)
+    uint8_t dePin;
+    uint8_t address;
+    FillFn fill;
+    uint8_t frame[MAX_FRAME]; ///< Trama en recepción
+    uint8_t length; ///< Bytes de la trama en recepción
+    bool overflow; ///< La trama no entró en el buffer
+    unsigned long lastRxUs; ///< Llegada del último byte
+    volatile bool transmitting; ///< El transceptor tiene el bus
+    unsigned long txDoneUs; ///< Fin estimado de la transmisión (host)
+    unsigned int servedCount;
+    unsigned int crcCount;
+
+    Node* table; ///< Copias de las unidades (maestro)
+    uint8_t nodes; ///< Unidades consultadas
+    uint8_t polled; ///< Índice de la unidad consultada o por consultar
+    bool awaiting; ///< Hay una consulta sin respuesta
+    unsigned long pollStartMs; ///< Envío de la consulta en curso
+    unsigned long pollPeriodMs; ///< Separación entre consultas
+};
+
+extern SensorBus bus;
+
+#endif
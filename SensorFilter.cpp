@@ -0,0 +1,57 @@
+/**
+ * @file SensorFilter.cpp
+ * @brief Implementación del filtro de canal.
+ */
+
+#include "SensorFilter.h"
+
+SensorFilter::SensorFilter(Mode mode, uint8_t emaShift)
+    : mode(mode), shift(emaShift < 8 ? emaShift : 8) {
+    reset();
+}
+
+void SensorFilter::reset() {
+    head = 0;
+    count = 0;
+    acc = 0;
+    out = 0;
+}
+
+int16_t SensorFilter::update(int16_t raw) {
+    int16_t x = raw;
+    if (mode == MEDIAN || mode == MEDIAN_EMA) {
+        window[head] = raw;
+        head = head + 1 < MEDIAN_TAPS ? head + 1 : 0;
+        if (count < MEDIAN_TAPS) count++;
+        x = median();
+    } else if (count == 0) {
+        count = 1;
+        acc = (int32_t)x << shift; ///< Arranca en la primera muestra
+    }
+
+    if (mode == EMA || mode == MEDIAN_EMA) {
+        if (mode == MEDIAN_EMA && count == 1) {
+            acc = (int32_t)x << shift;
+        }
+        acc += x - (acc >> shift); ///< acc = acc·(1 − 2^−k) + x
+        out = (acc + (shift ? (int32_t)1 << (shift - 1) : 0)) >> shift; ///< Con redondeo
+    } else {
+        out = x;
+    }
+    return out;
+}
+
+int16_t SensorFilter::median() const {
+    // Ordenamiento por inserción de una copia: a lo sumo 10 comparaciones.
+    int16_t v[MEDIAN_TAPS];
+    for (uint8_t i = 0; i < count; i++) {
+        int16_t x = window[i];
+        uint8_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+    return v[count / 2];
+}
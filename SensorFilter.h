@@ -0,0 +1,66 @@
+/**
+ * @file SensorFilter.h
+ * @brief Filtro de un canal de sensor en punto fijo.
+ *
+ * Se coloca entre la adquisición y la comparación con los umbrales para
+ * que una sola lectura ruidosa no cambie el estado del sistema. Ofrece
+ * una mediana de 5 muestras (descarta picos aislados), un promedio móvil
+ * exponencial entero (suaviza el ruido) o ambos en cascada. Usa solo
+ * enteros y memoria fija.
+ */
+
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Filtro de un canal.
+ */
+class SensorFilter {
+public:
+    /**
+     * @brief Etapas activas.
+     */
+    enum Mode : uint8_t {
+        NONE, ///< Pasa la muestra sin cambios
+        EMA, ///< Promedio móvil exponencial
+        MEDIAN, ///< Mediana de las últimas MEDIAN_TAPS muestras
+        MEDIAN_EMA ///< Mediana seguida del promedio exponencial
+    };
+
+    static const uint8_t MEDIAN_TAPS = 5; ///< Ventana de la mediana
+
+    /**
+     * @param mode Etapas del filtro.
+     * @param emaShift Peso de la muestra nueva en el promedio: 1 / 2^emaShift.
+     */
+    explicit SensorFilter(Mode mode, uint8_t emaShift = 2);
+
+    /**
+     * @brief Agrega una muestra.
+     *
+     * La primera muestra inicializa el filtro, de modo que no hay un
+     * transitorio desde cero.
+     *
+     * @return int16_t Valor filtrado.
+     */
+    int16_t update(int16_t raw);
+
+    int16_t value() const { return out; } ///< Último valor filtrado
+    bool primed() const { return count != 0; } ///< Indica si ya recibió alguna muestra
+    void reset(); ///< Descarta la historia
+
+private:
+    int16_t median() const; ///< Mediana de las muestras disponibles
+
+    Mode mode;
+    uint8_t shift; ///< emaShift
+    int16_t window[MEDIAN_TAPS]; ///< Últimas muestras (circular)
+    uint8_t head; ///< Próxima posición de la ventana
+    uint8_t count; ///< Muestras en la ventana
+    int32_t acc; ///< Promedio exponencial escalado por 2^shift
+    int16_t out; ///< Último valor filtrado
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file Settings.cpp
+ * @brief Implementación del bloque de configuración.
+ */
+
+#include "Settings.h"
+#include "TelemetryStream.h"
+#include <EEPROM.h>
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+bool SettingsData::valid() const {
+    return tempMinCenti < tempMaxCenti && humMinCenti < humMaxCenti && humMinCenti >= 0 &&
+           luxBaja < luxAlta && luxBaja >= 1 && paginaAmbientalMs >= 500 && paginaMs >= 500 &&
+           maxAttempts >= 1 && maxAttempts <= MAX_ATTEMPTS;
+}
+
+Settings::Settings(uint16_t eepromAddress, const SettingsData& defaults)
+    : address(eepromAddress), fallback(defaults), current(defaults), writeOffset(0), writeLeft(0) {}
+
+bool Settings::begin() {
+    current = fallback;
+    SettingsHeader h;
+    uint8_t* raw = block;
+    for (uint8_t i = 0; i < sizeof(SettingsHeader); i++) {
+        raw[i] = EEPROM.read(address + i);
+    }
+    memcpy(&h, raw, sizeof(h));
+    if (h.magic != MAGIC || h.length == 0 || h.length > sizeof(SettingsData) || h.length % 2) {
+        return false; ///< EEPROM virgen o de otro programa
+    }
+    uint8_t total = sizeof(SettingsHeader) + h.length;
+    for (uint8_t i = sizeof(SettingsHeader); i < total + 2; i++) {
+        raw[i] = EEPROM.read(address + i);
+    }
+    uint16_t crc = TelemetryStream::crc16(raw, total);
+    if (raw[total] != (crc >> 8) || raw[total + 1] != (crc & 0xFF)) {
+        return false; ///< Escritura interrumpida o bloque dañado
+    }
+
+    SettingsData loaded = fallback; ///< Los campos de versiones más nuevas quedan por defecto
+    memcpy(&loaded, raw + sizeof(SettingsHeader), h.length);
+    if (!loaded.valid()) {
+        return false;
+    }
+    current = loaded;
+    return true;
+}
+
+bool Settings::save(const SettingsData& next) {
+    if (!next.valid()) {
+        return false;
+    }
+    current = next;
+
+    SettingsHeader h = {MAGIC, VERSION, sizeof(SettingsData)};
+    memcpy(block, &h, sizeof(h));
+    memcpy(block + sizeof(h), &current, sizeof(current));
+    uint16_t crc = TelemetryStream::crc16(block, BLOCK_BYTES - 2);
+    block[BLOCK_BYTES - 2] = crc >> 8;
+    block[BLOCK_BYTES - 1] = crc & 0xFF;
+    writeOffset = 0;
+    writeLeft = BLOCK_BYTES; ///< Un guardado en curso se reinicia con los datos nuevos
+    return true;
+}
+
+void Settings::service() {
+    if (writeLeft == 0) {
+        return;
+    }
+#if defined(__AVR__)
+    if (!eeprom_is_ready()) return; ///< Escritura anterior en curso: no bloquear
+#endif
+    EEPROM.update(address + writeOffset, block[writeOffset]); ///< Solo escribe si cambió
+    writeOffset++;
+    writeLeft--;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file Settings.h
+ * @brief Configuración del sitio guardada en la EEPROM.
+ *
+ * Umbrales de alarma, tiempos de pantalla y límite de intentos que antes
+ * estaban fijos en el código. El bloque se lee una sola vez en setup() a
+ * una copia en RAM; el resto del programa solo lee esa copia. Guardar no
+ * bloquea: service() escribe de a un byte, como el registro de
+ * telemetría.
+ *
+ * Formato en EEPROM: encabezado (`SettingsHeader`), los `length` bytes de
+ * `SettingsData` y un CRC-16/CCITT-FALSE de ambos. Los campos nuevos se
+ * agregan siempre al final y suben `VERSION`; un bloque más corto de una
+ * versión anterior se carga y los campos que le faltan toman el valor por
+ * defecto.
+ */
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Valores configurables, en las unidades que usa el programa.
+ *
+ * Todos los campos son int16_t para que el menú los edite igual.
+ */
+struct __attribute__((packed)) SettingsData {
+    static const int16_t MAX_ATTEMPTS = 9; ///< Tope de `maxAttempts`; Lockout::fail() lo recibe como uint8_t
+
+    int16_t tempMinCenti; ///< Temperatura mínima segura (centésimas de °C)
+    int16_t tempMaxCenti; ///< Temperatura máxima segura (centésimas de °C)
+    int16_t humMinCenti; ///< Humedad mínima segura (centésimas de %)
+    int16_t humMaxCenti; ///< Humedad máxima segura (centésimas de %)
+    int16_t luxAlta; ///< Por encima de este valor la luz es alta
+    int16_t luxBaja; ///< Por debajo de este valor la luz es baja
+    int16_t paginaAmbientalMs; ///< Permanencia de la página ambiental
+    int16_t paginaMs; ///< Permanencia de las demás páginas del tablero
+    int16_t maxAttempts; ///< Intentos de clave antes del bloqueo
+
+    /**
+     * @brief Indica si los valores son coherentes entre sí.
+     */
+    bool valid() const;
+};
+static_assert(SettingsData::MAX_ATTEMPTS <= 255, "maxAttempts se pasa como uint8_t a Lockout::fail()");
+
+/**
+ * @brief Encabezado del bloque en EEPROM.
+ */
+struct __attribute__((packed)) SettingsHeader {
+    uint8_t magic; ///< `Settings::MAGIC`
+    uint8_t version; ///< Versión del formato que lo escribió
+    uint8_t length; ///< Bytes de `SettingsData` guardados
+};
+
+/**
+ * @brief Copia en RAM y persistencia del bloque de configuración.
+ */
+class Settings {
+public:
+    static const uint8_t MAGIC = 0xC5;
+    static const uint8_t VERSION = 1;
+    static const uint8_t BLOCK_BYTES = sizeof(SettingsHeader) + sizeof(SettingsData) + 2; ///< Bytes en EEPROM
+
+    /**
+     * @param eepromAddress Dirección del bloque.
+     * @param defaults Valores si la EEPROM no tiene un bloque válido.
+     */
+    Settings(uint16_t eepromAddress, const SettingsData& defaults);
+
+    /**
+     * @brief Carga el bloque de la EEPROM.
+     *
+     * @return false si no había un bloque válido y quedaron los valores
+     *         por defecto.
+     */
+    bool begin();
+
+    const SettingsData& data() const { return current; } ///< Copia en RAM
+    const SettingsData& defaults() const { return fallback; } ///< Valores de fábrica
+
+    /**
+     * @brief Reemplaza la configuración y la guarda en la EEPROM.
+     *
+     * La copia en RAM cambia de inmediato; la escritura la completa
+     * service().
+     *
+     * @return false si los valores no son válidos (no cambia nada).
+     */
+    bool save(const SettingsData& next);
+
+    /**
+     * @brief Avanza la escritura pendiente.
+     *
+     * Escribe como máximo un byte y solo si la EEPROM está libre.
+     */
+    void service();
+
+    bool saving() const { return writeLeft != 0; } ///< Indica si hay una escritura en curso
+
+private:
+    uint16_t address;
+    SettingsData fallback;
+    SettingsData current;
+    uint8_t block[BLOCK_BYTES]; ///< Bloque en escritura, con su CRC
+    uint8_t writeOffset; ///< Próximo byte a escribir
+    uint8_t writeLeft; ///< Bytes que faltan por escribir
+};
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file TelemetryLog.cpp
+ * @brief Implementación del registro de telemetría.
+ */
+
+#include "TelemetryLog.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+static_assert(sizeof(TelemetryRecord) == 8, "TelemetryRecord debe ocupar 8 bytes");
+static_assert(sizeof(TelemetryPageHeader) + TelemetryLog::PAGE_RECORDS * sizeof(TelemetryRecord) <= TelemetryLog::PAGE_BYTES,
+              "La página no cabe en PAGE_BYTES");
+
+TelemetryLog::TelemetryLog(uint16_t eepromStart, uint16_t eepromEnd)
+    : start(eepromStart), slots((eepromEnd - eepromStart) / PAGE_BYTES), head(0), count(0),
+      lastAppendMs(0), pending(0), pendingBaseS(0), flushFirst(0), flushSlot(0), flushOffset(0),
+      flushLeft(0), nextSeq(0), nextSlot(0) {}
+
+void TelemetryLog::begin() {
+    bool found = false;
+    uint16_t bestSeq = 0;
+    uint8_t bestSlot = 0;
+    TelemetryPageHeader h;
+    for (uint8_t slot = 0; slot < slots; slot++) {
+        if (!readHeader(slot, h, 0)) continue;
+        if (!found || (int16_t)(h.seq - bestSeq) > 0) { ///< Comparación segura ante el desborde de seq
+            found = true;
+            bestSeq = h.seq;
+            bestSlot = slot;
+        }
+    }
+    if (found) {
+        nextSeq = bestSeq + 1;
+        nextSlot = (bestSlot + 1) % slots; ///< Continúa tras la página más nueva
+    }
+    lastAppendMs = millis();
+}
+
+void TelemetryLog::append(float temperature, float humidity, bool dhtValid, uint16_t lightAdc,
+                          bool ir, bool hall, uint8_t state) {
+    unsigned long now = millis();
+    unsigned long deltaDs = (now - lastAppendMs) / 100;
+    lastAppendMs = now;
+
+    TelemetryRecord& r = ring[head];
+    r.deltaDs = deltaDs > 0xFFFF ? 0xFFFF : deltaDs;
+    r.tempCenti = dhtValid ? (int16_t)(temperature * 100) : 0;
+    r.humCenti = dhtValid ? (uint16_t)(humidity * 100) : 0;
+    r.lightFlags = (lightAdc & TelemetryRecord::LIGHT_MASK) | ((uint16_t)state << TelemetryRecord::STATE_SHIFT);
+    if (ir) r.lightFlags |= TelemetryRecord::FLAG_IR;
+    if (hall) r.lightFlags |= TelemetryRecord::FLAG_HALL;
+    if (dhtValid) r.lightFlags |= TelemetryRecord::FLAG_DHT_VALID;
+
+    head = (head + 1) & (RAM_RECORDS - 1);
+    if (count < RAM_RECORDS) count++;
+
+    if (pending == 0) pendingBaseS = now / 1000;
+    if (pending < RAM_RECORDS) pending++; ///< Si la EEPROM no alcanza, se pierden las más antiguas
+}
+
+const TelemetryRecord& TelemetryLog::recent(uint8_t age) const {
+    return ring[(head - 1 - age) & (RAM_RECORDS - 1)];
+}
+
+void TelemetryLog::service() {
+    if (flushLeft == 0) {
+        if (pending < PAGE_RECORDS || slots == 0) return;
+
+        // Nueva página con las PAGE_RECORDS muestras pendientes más antiguas.
+        flushFirst = (head - pending) & (RAM_RECORDS - 1);
+        flushHeader.seq = nextSeq++;
+        flushHeader.baseS = pendingBaseS;
+        flushHeader.count = PAGE_RECORDS;
+        flushSlot = nextSlot;
+        nextSlot = (nextSlot + 1) % slots;
+        flushOffset = 0;
+        flushLeft = sizeof(TelemetryPageHeader) + PAGE_RECORDS * sizeof(TelemetryRecord);
+
+        uint8_t crc = 0;
+        for (uint8_t i = 0; i < flushLeft; i++) {
+            if (i == offsetof(TelemetryPageHeader, crc)) continue;
+            crc = crc8(crc, pageByte(i));
+        }
+        flushHeader.crc = crc;
+
+        // La base de la siguiente página es el tiempo de la primera muestra que queda.
+        pending -= PAGE_RECORDS;
+        uint32_t elapsedDs = 0;
+        for (uint8_t i = 1; i <= PAGE_RECORDS && pending; i++) {
+            elapsedDs += ring[(flushFirst + i) & (RAM_RECORDS - 1)].deltaDs;
+        }
+        pendingBaseS += elapsedDs / 10;
+        return;
+    }
+
+#if defined(__AVR__)
+    if (!eeprom_is_ready()) return; ///< Escritura anterior en curso: no bloquear
+#endif
+    EEPROM.update(slotAddress(flushSlot) + flushOffset, pageByte(flushOffset)); ///< Solo escribe si cambió
+    flushOffset++;
+    flushLeft--;
+}
+
+uint8_t TelemetryLog::pageByte(uint8_t offset) const {
+    if (offset < sizeof(TelemetryPageHeader)) {
+        return ((const uint8_t*)&flushHeader)[offset];
+    }
+    offset -= sizeof(TelemetryPageHeader);
+    const TelemetryRecord& r = ring[(flushFirst + offset / sizeof(TelemetryRecord)) & (RAM_RECORDS - 1)];
+    return ((const uint8_t*)&r)[offset % sizeof(TelemetryRecord)];
+}
+
+bool TelemetryLog::readHeader(uint8_t slot, TelemetryPageHeader& header, TelemetryRecord* records) const {
+    uint16_t addr = slotAddress(slot);
+    uint8_t* h = (uint8_t*)&header;
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < sizeof(TelemetryPageHeader); i++) {
+        h[i] = EEPROM.read(addr + i);
+        if (i != offsetof(TelemetryPageHeader, crc)) crc = crc8(crc, h[i]);
+    }
+    if (header.count != PAGE_RECORDS) return false; ///< Página vacía o borrada
+    uint8_t* out = (uint8_t*)records;
+    for (uint8_t i = 0; i < PAGE_RECORDS * sizeof(TelemetryRecord); i++) {
+        uint8_t b = EEPROM.read(addr + sizeof(TelemetryPageHeader) + i);
+        crc = crc8(crc, b);
+        if (out) out[i] = b;
+    }
+    return crc == header.crc;
+}
+
+bool TelemetryLog::readPage(uint8_t age, TelemetryPageHeader& header, TelemetryRecord* records) const {
+    if (age >= slots) return false;
+    return readHeader((nextSlot + age) % slots, header, records); ///< nextSlot es la página más antigua
+}
+
+uint8_t TelemetryLog::crc8(uint8_t crc, uint8_t data) {
+    crc ^= data;
+    for (uint8_t i = 0; i < 8; i++) { ///< Polinomio 0x07 (CRC-8/SMBUS)
+        crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file TelemetryLog.h
+ * @brief Registro compacto de muestras en RAM y EEPROM.
+ *
+ * Cada muestra ocupa 8 bytes: delta de tiempo, temperatura y humedad en
+ * punto fijo, lectura cruda del fotoresistor y banderas de eventos. Las
+ * últimas muestras quedan en una cola circular en RAM; cada vez que se
+ * completa una página se copia a la EEPROM, rotando entre todas las
+ * páginas de la región para repartir el desgaste. La escritura avanza un
+ * byte por llamada a service(), así que nunca bloquea el bucle.
+ */
+
+#ifndef TELEMETRY_LOG_H
+#define TELEMETRY_LOG_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Muestra empaquetada (8 bytes).
+ */
+struct __attribute__((packed)) TelemetryRecord {
+    static const uint16_t LIGHT_MASK = 0x03FF; ///< Bits de la lectura del ADC
+    static const uint16_t FLAG_IR = 1u << 10; ///< Hubo flanco infrarrojo desde la muestra anterior
+    static const uint16_t FLAG_HALL = 1u << 11; ///< Hubo flanco Hall desde la muestra anterior
+    static const uint16_t FLAG_DHT_VALID = 1u << 12; ///< Temperatura y humedad válidas
+    static const uint8_t STATE_SHIFT = 13; ///< Posición del estado del sistema (3 bits)
+
+    uint16_t deltaDs; ///< Décimas de segundo desde la muestra anterior (saturado)
+    int16_t tempCenti; ///< Temperatura en centésimas de °C
+    uint16_t humCenti; ///< Humedad en centésimas de %
+    uint16_t lightFlags; ///< ADC del fotoresistor (10 bits), banderas y estado
+
+    uint16_t light() const { return lightFlags & LIGHT_MASK; } ///< Lectura del ADC
+    uint8_t state() const { return lightFlags >> STATE_SHIFT; } ///< Estado del sistema
+};
+
+/**
+ * @brief Encabezado de una página en EEPROM (8 bytes).
+ */
+struct __attribute__((packed)) TelemetryPageHeader {
+    uint16_t seq; ///< Número de secuencia de la página
+    uint32_t baseS; ///< Tiempo encendido de la primera muestra (s)
+    uint8_t count; ///< Muestras en la página
+    uint8_t crc; ///< CRC-8 de encabezado y muestras
+};
+
+/**
+ * @brief Registro de telemetría.
+ */
+class TelemetryLog {
+public:
+    static const uint8_t RAM_RECORDS = 32; ///< Muestras en RAM (potencia de 2)
+    static const uint8_t PAGE_BYTES = 128; ///< Tamaño de una página en EEPROM
+    static const uint8_t PAGE_RECORDS = (PAGE_BYTES - sizeof(TelemetryPageHeader)) / sizeof(TelemetryRecord); ///< Muestras por página
+
+    /**
+     * @param eepromStart Primera dirección de la región.
+     * @param eepromEnd Dirección final (exclusiva) de la región.
+     */
+    TelemetryLog(uint16_t eepromStart, uint16_t eepromEnd);
+
+    /**
+     * @brief Busca en la EEPROM la página más reciente para continuar tras ella.
+     */
+    void begin();
+
+    /**
+     * @brief Agrega una muestra.
+     *
+     * @param temperature Temperatura en °C (se ignora si @p dhtValid es false).
+     * @param humidity Humedad en %.
+     * @param dhtValid Indica si temperatura y humedad son válidas.
+     * @param lightAdc Lectura cruda del fotoresistor.
+     * @param ir Hubo flanco infrarrojo desde la muestra anterior.
+     * @param hall Hubo flanco Hall desde la muestra anterior.
+     * @param state Estado del sistema (0–7).
+     */
+    void append(float temperature, float humidity, bool dhtValid, uint16_t lightAdc,
+                bool ir, bool hall, uint8_t state);
+
+    /**
+     * @brief Avanza la copia pendiente a la EEPROM.
+     *
+     * Escribe como máximo un byte y solo si la EEPROM está libre.
+     */
+    void service();
+
+    uint8_t size() const { return count; } ///< Muestras disponibles en RAM
+    const TelemetryRecord& recent(uint8_t age) const; ///< Muestra en RAM (0 = la más reciente)
+    uint8_t pageSlots() const { return slots; } ///< Páginas que caben en la región
+
+    /**
+     * @brief Lee una página guardada, de la más antigua a la más nueva.
+     *
+     * @param age 0 para la página más antigua.
+     * @param header Encabezado leído.
+     * @param records Arreglo de @c PAGE_RECORDS muestras.
+     * @return false si la página no existe o su CRC no coincide.
+     */
+    bool readPage(uint8_t age, TelemetryPageHeader& header, TelemetryRecord* records) const;
+
+    bool flushing() const { return flushLeft != 0; } ///< Indica si hay una copia en curso
+
+private:
+    uint8_t pageByte(uint8_t offset) const; ///< Byte de la página en copia
+    uint16_t slotAddress(uint8_t slot) const { return start + (uint16_t)slot * PAGE_BYTES; }
+    bool readHeader(uint8_t slot, TelemetryPageHeader& header, TelemetryRecord* records) const;
+    static uint8_t crc8(uint8_t crc, uint8_t data);
+
+    uint16_t start; ///< Inicio de la región en EEPROM
+    uint8_t slots; ///< Páginas de la región
+
+    TelemetryRecord ring[RAM_RECORDS]; ///< Últimas muestras
+    uint8_t head; ///< Próxima posición de la cola
+    uint8_t count; ///< Muestras en la cola
+    unsigned long lastAppendMs; ///< Instante de la última muestra
+
+    uint8_t pending; ///< Muestras aún no copiadas a una página
+    uint32_t pendingBaseS; ///< Tiempo de la primera muestra pendiente
+
+    TelemetryPageHeader flushHeader; ///< Encabezado de la página en copia
+    uint8_t flushFirst; ///< Posición en la cola de la primera muestra en copia
+    uint8_t flushSlot; ///< Página de destino
+    uint8_t flushOffset; ///< Próximo byte a escribir
+    uint8_t flushLeft; ///< Bytes que faltan por escribir
+
+    uint16_t nextSeq; ///< Secuencia de la próxima página
+    uint8_t nextSlot; ///< Próxima página a escribir
+};
+
+extern TelemetryLog telemetria; ///< Registro de telemetría del sistema
+
+#endif
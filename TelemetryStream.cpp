@@ -0,0 +1,69 @@
+/**
+ * @file TelemetryStream.cpp
+ * @brief Implementación de la transmisión binaria de telemetría.
+ */
+
+#include "TelemetryStream.h"
+
+TelemetryStream stream;
+
+TelemetryStream::TelemetryStream() : enabledFlag(true), seq(0), droppedCount(0), sentCount(0) {}
+
+void TelemetryStream::begin(unsigned long baud) {
+    Serial.begin(baud);
+}
+
+bool TelemetryStream::send(TelemetryFrame& frame) {
+    if (!enabledFlag) { ///< La UART está en uso para otra cosa (banco de pruebas)
+        return false;
+    }
+    if (Serial.availableForWrite() < WIRE_BYTES) { ///< No cabe: descartar en lugar de esperar
+        droppedCount++;
+        return false;
+    }
+
+    frame.seq = seq++;
+    frame.timeMs = millis();
+
+    uint8_t payload[PAYLOAD_BYTES];
+    memcpy(payload, &frame, sizeof(frame));
+    uint16_t crc = crc16(payload, sizeof(frame));
+    payload[sizeof(frame)] = crc >> 8;
+    payload[sizeof(frame) + 1] = crc & 0xFF;
+
+    uint8_t wire[WIRE_BYTES];
+    uint8_t n = cobsEncode(payload, PAYLOAD_BYTES, wire);
+    Serial.write(wire, n); ///< La UART lo transmite desde su buffer por interrupción
+    sentCount++;
+    return true;
+}
+
+uint16_t TelemetryStream::crc16(const uint8_t* data, uint8_t length) {
+    uint16_t crc = 0xFFFF;
+    while (length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+uint8_t TelemetryStream::cobsEncode(const uint8_t* data, uint8_t length, uint8_t* out) {
+    uint8_t codeIndex = 0; ///< Posición del byte de código del bloque actual
+    uint8_t code = 1; ///< Distancia al próximo cero
+    uint8_t o = 1;
+    for (uint8_t i = 0; i < length; i++) {
+        if (data[i] == 0) {
+            out[codeIndex] = code;
+            codeIndex = o++;
+            code = 1;
+        } else {
+            out[o++] = data[i];
+            code++; ///< Las tramas son cortas: nunca se llega a bloques de 254 bytes
+        }
+    }
+    out[codeIndex] = code;
+    out[o++] = 0x00; ///< Delimitador de trama
+    return o;
+}
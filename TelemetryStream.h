@@ -0,0 +1,92 @@
+/**
+ * @file TelemetryStream.h
+ * @brief Transmisión binaria de telemetría por la UART.
+ *
+ * Cada trama tiene tamaño fijo: 14 bytes de datos más un CRC-16, todo
+ * codificado con COBS y terminado en 0x00 (18 bytes por trama). La trama
+ * solo se entrega a Serial si cabe completa en su buffer de transmisión,
+ * que se vacía por la interrupción de registro de datos vacío de la UART;
+ * si no cabe se descarta y se cuenta, de modo que transmitir nunca bloquea
+ * la máquina de estados.
+ */
+
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Contenido de una trama (antes del CRC y de COBS).
+ */
+struct __attribute__((packed)) TelemetryFrame {
+    /**
+     * @brief Tipo de trama.
+     */
+    enum Type {
+        SAMPLE = 0x01, ///< Muestra periódica de todos los canales
+        TRANSITION = 0x02 ///< Cambio de estado (con la muestra del momento)
+    };
+
+    static const uint8_t FLAG_IR = 0x01; ///< Nivel actual del sensor infrarrojo
+    static const uint8_t FLAG_HALL = 0x02; ///< Nivel actual del sensor Hall
+    static const uint8_t FLAG_DHT_VALID = 0x04; ///< Temperatura y humedad válidas
+
+    uint8_t type; ///< Tipo de trama (Type)
+    uint8_t seq; ///< Número de secuencia para detectar pérdidas
+    uint32_t timeMs; ///< millis() al armar la trama
+    int16_t tempCenti; ///< Temperatura en centésimas de °C
+    uint16_t humCenti; ///< Humedad en centésimas de %
+    uint16_t light; ///< Lectura cruda del fotoresistor
+    uint8_t flags; ///< Banderas FLAG_*
+    uint8_t state; ///< Estado actual (nibble bajo) y anterior (nibble alto)
+};
+
+/**
+ * @brief Emisor de tramas COBS con CRC-16 sobre Serial.
+ */
+class TelemetryStream {
+public:
+    static const uint8_t PAYLOAD_BYTES = sizeof(TelemetryFrame) + 2; ///< Datos más CRC-16
+    static const uint8_t WIRE_BYTES = PAYLOAD_BYTES + 2; ///< Con el byte de COBS y el delimitador
+
+    TelemetryStream();
+
+    void begin(unsigned long baud); ///< Abre el puerto serie
+
+    /**
+     * @brief Envía una trama si cabe en el buffer de transmisión.
+     *
+     * Completa el número de secuencia y el tiempo.
+     *
+     * @return false si se descartó por falta de espacio o si el envío
+     *         está suspendido.
+     */
+    bool send(TelemetryFrame& frame);
+
+    void setEnabled(bool on) { enabledFlag = on; } ///< Suspende o reanuda el envío de tramas
+    bool enabled() const { return enabledFlag; } ///< Indica si se envían tramas
+    uint16_t dropped() const { return droppedCount; } ///< Tramas descartadas
+    uint16_t sent() const { return sentCount; } ///< Tramas enviadas
+
+    /**
+     * @brief CRC-16/CCITT-FALSE (polinomio 0x1021, valor inicial 0xFFFF).
+     */
+    static uint16_t crc16(const uint8_t* data, uint8_t length);
+
+    /**
+     * @brief Codifica con COBS y agrega el delimitador 0x00.
+     *
+     * @return uint8_t Bytes escritos en @p out (length + 2).
+     */
+    static uint8_t cobsEncode(const uint8_t* data, uint8_t length, uint8_t* out);
+
+private:
+    bool enabledFlag; ///< Si es false, send() no transmite nada
+    uint8_t seq; ///< Próximo número de secuencia
+    uint16_t droppedCount; ///< Tramas descartadas
+    uint16_t sentCount; ///< Tramas enviadas
+};
+
+extern TelemetryStream stream; ///< Salida de telemetría por la UART
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file TonePlayer.cpp
+ * @brief Implementación del secuenciador de tonos y patrones del sistema.
+ */
+
+#include "TonePlayer.h"
+
+static const ToneStep NOTAS_ALARMA[] PROGMEM = {
+    {1000, 250}, ///< Tono de 1000 Hz durante 250 ms
+    {500, 250}, ///< Tono de 500 Hz durante 250 ms
+};
+
+static const ToneStep NOTAS_BIENVENIDA[] PROGMEM = {
+    {262, 500}, ///< Tono de do durante 500 ms
+    {330, 500}, ///< Tono de mi durante 500 ms
+    {392, 500}, ///< Tono de sol durante 500 ms
+};
+
+const TonePattern PATRON_ALARMA PROGMEM = {NOTAS_ALARMA, 2, 5};
+const TonePattern PATRON_BIENVENIDA PROGMEM = {NOTAS_BIENVENIDA, 3, 1};
+
+TonePlayer::TonePlayer(uint8_t pin)
+    : pin(pin), pattern(0), steps(0), length(0), step(0), repeatsLeft(0), stepEnd(0) {}
+
+void TonePlayer::start(const TonePattern* p) {
+    length = pgm_read_byte(&p->length);
+    if (length == 0) { ///< playStep() leería fuera de la tabla
+        stop();
+        return;
+    }
+    uint8_t repeats = pgm_read_byte(&p->repeats);
+    pattern = p;
+    steps = (const ToneStep*)pgm_read_ptr(&p->steps);
+    repeatsLeft = repeats ? repeats - 1 : 0; ///< Se toca al menos una vez
+    step = 0;
+    stepEnd = millis();
+    playStep();
+}
+
+void TonePlayer::stop() {
+    pattern = 0;
+    noTone(pin); ///< Detener el sonido del buzzer
+}
+
+void TonePlayer::update() {
+    if (!pattern || (long)(millis() - stepEnd) < 0) { ///< Nada sonando o nota en curso
+        return;
+    }
+    if (++step >= length) { ///< Fin de una repetición
+        if (repeatsLeft == 0) {
+            stop();
+            return;
+        }
+        repeatsLeft--;
+        step = 0;
+    }
+    playStep();
+}
+
+void TonePlayer::playStep() {
+    uint16_t freq = pgm_read_word(&steps[step].freqHz);
+    uint16_t duration = pgm_read_word(&steps[step].durationMs);
+    if (freq) {
+        tone(pin, freq); ///< El fin de la nota lo controla update()
+    } else {
+        noTone(pin);
+    }
+    stepEnd += duration; ///< Acumula para no desfasar la melodía si update() llega tarde
+}
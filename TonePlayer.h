@@ -0,0 +1,74 @@
+/**
+ * @file TonePlayer.h
+ * @brief Secuenciador de tonos no bloqueante para el buzzer.
+ *
+ * Reproduce patrones definidos como tablas en PROGMEM (frecuencia,
+ * duración y número de repeticiones). El avance de nota lo hace update(),
+ * llamada periódicamente desde una tarea del planificador, de modo que el
+ * resto del sistema sigue funcionando mientras suena una melodía.
+ */
+
+#ifndef TONE_PLAYER_H
+#define TONE_PLAYER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Nota de un patrón.
+ */
+struct ToneStep {
+    uint16_t freqHz; ///< Frecuencia en Hz (0 = silencio)
+    uint16_t durationMs; ///< Duración de la nota en ms
+};
+
+/**
+ * @brief Patrón de tonos almacenado en PROGMEM.
+ */
+struct TonePattern {
+    const ToneStep* steps; ///< Notas del patrón (en PROGMEM)
+    uint8_t length; ///< Número de notas
+    uint8_t repeats; ///< Veces que se repite el patrón completo (0 equivale a 1)
+};
+
+/**
+ * @brief Reproductor de patrones de tonos.
+ */
+class TonePlayer {
+public:
+    explicit TonePlayer(uint8_t pin);
+
+    /**
+     * @brief Inicia un patrón, reemplazando al que esté sonando.
+     *
+     * Un patrón sin notas solo detiene el que estaba sonando.
+     *
+     * @param pattern Patrón en PROGMEM.
+     */
+    void start(const TonePattern* pattern);
+
+    void stop(); ///< Detiene el patrón y silencia el buzzer
+    bool isPlaying() const { return pattern != 0; } ///< Indica si hay un patrón sonando
+
+    /**
+     * @brief Avanza el patrón si la nota actual terminó.
+     *
+     * Debe llamarse con un periodo menor que la nota más corta.
+     */
+    void update();
+
+private:
+    void playStep(); ///< Emite la nota actual y calcula su fin
+
+    uint8_t pin; ///< Pin del buzzer
+    const TonePattern* pattern; ///< Patrón en curso (0 si no hay)
+    const ToneStep* steps; ///< Copia en RAM del puntero a notas
+    uint8_t length; ///< Copia en RAM del número de notas
+    uint8_t step; ///< Índice de la nota actual
+    uint8_t repeatsLeft; ///< Repeticiones restantes tras la actual
+    unsigned long stepEnd; ///< Instante (millis) en que termina la nota
+};
+
+extern const TonePattern PATRON_ALARMA; ///< Alarma: 1000 Hz / 500 Hz alternados, 5 veces
+extern const TonePattern PATRON_BIENVENIDA; ///< Bienvenida: do, mi, sol
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file Watchdog.cpp
+ * @brief Implementación del vigilante de latidos.
+ */
+
+#include "Watchdog.h"
+#include "Scheduler.h"
+#if defined(__AVR__)
+#include <avr/wdt.h>
+#endif
+
+Watchdog watchdog;
+
+#if defined(__AVR__)
+#define NOINIT __attribute__((section(".noinit")))
+#else
+#define NOINIT
+#endif
+
+static Watchdog::ResetInfo record NOINIT; ///< Sobrevive al reinicio: la inicialización de C no la toca
+
+#if defined(__AVR__)
+static uint8_t resetFlags NOINIT; ///< MCUSR al arrancar
+
+/**
+ * @brief Apaga el watchdog antes de la inicialización de C.
+ *
+ * Tras un reinicio por watchdog el periférico sigue activo con el plazo
+ * más corto; si no se apaga aquí, vuelve a vencer antes de setup().
+ */
+void watchdogEarlyInit() __attribute__((naked, used, section(".init3")));
+void watchdogEarlyInit() {
+    resetFlags = MCUSR;
+    MCUSR = 0;
+    wdt_disable();
+}
+#endif
+
+Watchdog::Watchdog() : watchCount(0), starving(-1), currentState(0), starveCount(0) {
+    memset(&last, 0, sizeof(last));
+    last.task = -1;
+}
+
+bool Watchdog::watch(int8_t taskId, unsigned long deadlineMs) {
+    if (watchCount >= MAX_WATCHES || taskId < 0 || taskId >= scheduler.count()) {
+        return false;
+    }
+    Watch w = {taskId, deadlineMs};
+    watches[watchCount++] = w;
+    return true;
+}
+
+void Watchdog::begin() {
+    bool valid = record.magic == MAGIC;
+#if defined(__AVR__)
+    valid = valid && (resetFlags & bit(WDRF)); ///< Al encender, la RAM trae basura
+#endif
+    if (valid) {
+        last = record;
+        last.count++;
+    }
+    record.magic = 0; ///< Se consume; la ISR la vuelve a escribir
+    record.count = last.count;
+
+#if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    wdt_reset();
+    WDTCSR = bit(WDCE) | bit(WDE); ///< Secuencia temporizada para cambiar el modo
+    WDTCSR = bit(WDIE) | bit(WDE) | bit(WDP2); ///< Interrupción y luego reinicio, 250 ms
+    SREG = oldSREG;
+#endif
+}
+
+void Watchdog::service(uint8_t state) {
+    currentState = state;
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < watchCount; i++) {
+        const Watch& w = watches[i];
+        if (now - scheduler.task(w.task).lastRunMs > w.deadlineMs) {
+            if (starving < 0) starveCount++;
+            starving = w.task; ///< Sin alimentar: el watchdog vence
+            return;
+        }
+    }
+    starving = -1;
+#if defined(__AVR__)
+    wdt_reset();
+    if (!(WDTCSR & bit(WDIE))) { ///< Venció una vez pero el sistema se recuperó
+        record.magic = 0;
+        WDTCSR |= bit(WDIE); ///< Vuelve a anotar antes de reiniciar
+    }
+#endif
+}
+
+void Watchdog::onTimeout() {
+    int8_t running = scheduler.running();
+    record.task = running >= 0 ? running : starving; ///< Una tarea colgada es la culpable
+    record.state = currentState;
+    record.uptimeMs = millis();
+    record.magic = MAGIC;
+}
+
+#if defined(__AVR__) && defined(WDT_vect)
+ISR(WDT_vect) {
+    watchdog.onTimeout(); ///< El hardware limpia WDIE: el próximo vencimiento reinicia
+}
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file Watchdog.h
+ * @brief Supervisión de las tareas con el watchdog del AVR.
+ *
+ * El watchdog se alimenta desde loop() solo si cada tarea vigilada
+ * terminó una ejecución dentro de su plazo; el latido es el fin de la
+ * ejecución que registra el planificador. Si una tarea queda colgada (una
+ * lectura del DHT que no vuelve) o deja de ejecutarse, el watchdog vence
+ * en `TIMEOUT_MS`: primero dispara su interrupción, que anota la tarea
+ * culpable y el estado en RAM `.noinit`, y en el siguiente vencimiento
+ * reinicia el microcontrolador. Tras el reinicio begin() recupera esa
+ * anotación para el menú de diagnóstico.
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Vigilante de latidos de las tareas.
+ */
+class Watchdog {
+public:
+    static const uint8_t MAX_WATCHES = 6; ///< Tareas que se pueden vigilar
+    static const uint16_t TIMEOUT_MS = 250; ///< Vencimiento del watchdog (interrupción; el reinicio llega en otro tanto)
+    static const uint16_t MAGIC = 0x5744; ///< Marca de una anotación válida
+
+    /**
+     * @brief Anotación del último reinicio por watchdog.
+     */
+    struct ResetInfo {
+        uint16_t magic; ///< `MAGIC` si la anotación es válida
+        int8_t task; ///< Tarea culpable (-1 si no se supo)
+        uint8_t state; ///< Estado de la máquina de estados
+        unsigned long uptimeMs; ///< Tiempo encendido al vencer
+        uint8_t count; ///< Reinicios por watchdog desde el último encendido
+    };
+
+    Watchdog();
+
+    /**
+     * @brief Vigila una tarea del planificador.
+     *
+     * @param taskId Identificador devuelto por `Scheduler::addTask()`.
+     * @param deadlineMs Tiempo máximo entre dos ejecuciones completas.
+     * @return false si no hay lugar o la tarea no existe.
+     */
+    bool watch(int8_t taskId, unsigned long deadlineMs);
+
+    /**
+     * @brief Recupera la anotación del reinicio anterior y arranca el watchdog.
+     *
+     * Se llama al final de setup(), cuando ya no quedan esperas largas.
+     */
+    void begin();
+
+    /**
+     * @brief Revisa los latidos y alimenta el watchdog si todos están al día.
+     *
+     * Se llama desde loop() después de `Scheduler::run()`.
+     *
+     * @param state Estado actual, para la anotación.
+     */
+    void service(uint8_t state);
+
+    void onTimeout(); ///< Anota la falla; la llama la ISR del watchdog
+
+    bool hadReset() const { return last.magic == MAGIC; } ///< El arranque fue un reinicio por watchdog
+    const ResetInfo& lastReset() const { return last; } ///< Anotación del reinicio anterior
+    unsigned int starvations() const { return starveCount; } ///< Veces que una tarea se atrasó
+
+private:
+    /**
+     * @brief Tarea vigilada.
+     */
+    struct Watch {
+        int8_t task; ///< Identificador en el planificador
+        unsigned long deadlineMs; ///< Plazo entre latidos
+    };
+
+    Watch watches[MAX_WATCHES];
+    uint8_t watchCount;
+    ResetInfo last; ///< Copia de la anotación leída al arrancar
+    volatile int8_t starving; ///< Tarea atrasada que detuvo la alimentación (-1 si ninguna)
+    volatile uint8_t currentState; ///< Último estado informado por service()
+    unsigned int starveCount;
+};
+
+extern Watchdog watchdog; ///< Vigilante del sistema
+
+#endif
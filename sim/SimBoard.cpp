@@ -0,0 +1,283 @@
+/**
+ * @file SimBoard.cpp
+ * @brief Placa simulada y funciones de Arduino que la usan.
+ */
+
+#include "SimBoard.h"
+#include <DHT.h>
+#include <EEPROM.h>
+#include <LiquidCrystal.h>
+#include <algorithm>
+#include <stdarg.h>
+
+SimBoard board;
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+EEPROMClass EEPROM;
+LiquidCrystal* simLcd = 0;
+
+volatile uint8_t simDdr[NUM_DIGITAL_PINS];
+volatile uint8_t simPort[NUM_DIGITAL_PINS];
+volatile uint8_t simPin[NUM_DIGITAL_PINS];
+
+SimBoard::SimBoard()
+    : clockUs(0), adcReads(0), toneFreq(0), pinChange(0), dhtOk(false), dhtTemperature(NAN),
+      dhtHumidity(NAN), keymap(0), pressed(0) {
+    memset(adc, 0, sizeof(adc));
+    memset(rowPins, 0, sizeof(rowPins));
+    memset(colPins, 0, sizeof(colPins));
+    for (uint8_t i = 0; i < UARTS; i++) {
+        uart[i].baud = 0;
+        uart[i].bits = 10;
+        uart[i].txQueued = 0;
+        uart[i].txElapsedUs = 0;
+    }
+}
+
+void SimBoard::advanceUs(uint64_t us) {
+    clockUs += us;
+    for (uint8_t i = 0; i < UARTS; i++) {
+        Uart& u = uart[i];
+        if (u.baud == 0 || u.txQueued == 0) {
+            u.txElapsedUs = 0;
+            continue;
+        }
+        u.txElapsedUs += us;
+        uint64_t sent = u.txElapsedUs * u.baud / (u.bits * 1000000ULL);
+        if (sent >= (uint64_t)u.txQueued) {
+            u.txQueued = 0;
+            u.txElapsedUs = 0;
+        } else {
+            u.txQueued -= (int)sent;
+            u.txElapsedUs -= sent * u.bits * 1000000ULL / u.baud;
+        }
+    }
+}
+
+void SimBoard::setDigital(uint8_t pin, uint8_t level) {
+    uint8_t v = level ? 1 : 0;
+    if (simPin[pin] == v) return;
+    simPin[pin] = v;
+    if (pinChange) pinChange(); ///< Como la ISR de cambio de pin
+}
+
+void SimBoard::setAnalog(uint8_t pin, uint16_t value) {
+    if (pin < A0) pin += A0; ///< analogRead(0) equivale a analogRead(A0)
+    adc[pin] = value > 1023 ? 1023 : value;
+}
+
+void SimBoard::setDht(float temperature, float humidity) {
+    dhtOk = true;
+    dhtTemperature = temperature;
+    dhtHumidity = humidity;
+}
+
+void SimBoard::failDht() {
+    dhtOk = false;
+}
+
+void SimBoard::attachKeypad(const char* map, const byte* rows, const byte* cols) {
+    keymap = map;
+    memcpy(rowPins, rows, sizeof(rowPins));
+    memcpy(colPins, cols, sizeof(colPins));
+    settleMatrix();
+}
+
+bool SimBoard::press(char key) {
+    if (!keymap) return false;
+    for (uint8_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        if (keymap[i] == key) {
+            pressed |= 1 << i;
+            settleMatrix();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimBoard::release(char key) {
+    if (!keymap) return;
+    for (uint8_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        if (keymap[i] == key) pressed &= ~(1 << i);
+    }
+    settleMatrix();
+}
+
+void SimBoard::settleMatrix() {
+    if (!keymap) return;
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        uint8_t level = simPort[rowPins[r]] ? 1 : 0; ///< Pull-up de la fila
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            bool driven = simDdr[colPins[c]] && !simPort[colPins[c]]; ///< Columna activa en LOW
+            if (driven && (pressed & (1 << (r * MATRIX_COLS + c)))) level = 0;
+        }
+        simPin[rowPins[r]] = level;
+    }
+}
+
+void SimBoard::pinModeCall(uint8_t pin, uint8_t mode) {
+    simDdr[pin] = mode == OUTPUT;
+    if (mode == INPUT_PULLUP) simPort[pin] = 1;
+    else if (mode == INPUT) simPort[pin] = 0;
+}
+
+void SimBoard::digitalWriteCall(uint8_t pin, uint8_t val) {
+    simPort[pin] = val ? 1 : 0;
+    if (simDdr[pin]) simPin[pin] = simPort[pin]; ///< Un pin de salida se lee a sí mismo
+}
+
+int SimBoard::analogReadCall(uint8_t pin) {
+    if (pin < A0) pin += A0;
+    adcReads++;
+    advanceUs(112); ///< Una conversión dura 13 ciclos del ADC a 125 kHz
+    return adc[pin];
+}
+
+bool SimBoard::dhtRead(float& temperature, float& humidity) {
+    advanceUs(DHT::READ_US); ///< La transacción real bloquea ~5 ms
+    if (!dhtOk) {
+        temperature = humidity = NAN;
+        return false;
+    }
+    temperature = dhtTemperature;
+    humidity = dhtHumidity;
+    return true;
+}
+
+void SimBoard::serialBegin(uint8_t port, unsigned long b, uint8_t bitsPerChar) {
+    Uart& u = uart[port];
+    u.baud = b;
+    u.bits = bitsPerChar;
+    u.txQueued = 0;
+    u.txElapsedUs = 0;
+}
+
+int SimBoard::serialAvailableForWrite(uint8_t port) const {
+    return HardwareSerial::TX_BUFFER_SIZE - 1 - uart[port].txQueued;
+}
+
+bool SimBoard::serialWrite(uint8_t port, uint8_t c) {
+    Uart& u = uart[port];
+    if (u.baud == 0) return false;
+    while (serialAvailableForWrite(port) <= 0) { ///< HardwareSerial espera a que se libere lugar
+        advanceUs(u.bits * 1000000ULL / u.baud + 1);
+    }
+    u.txQueued++;
+    u.txLog.push_back(c);
+    return true;
+}
+
+void SimBoard::serialInject(uint8_t port, const uint8_t* data, size_t n) {
+    Uart& u = uart[port];
+    uint64_t charUs = u.baud ? u.bits * 1000000ULL / u.baud : 0;
+    uint64_t at = u.rx.empty() ? clockUs : std::max(clockUs, u.rx.back().first);
+    for (size_t i = 0; i < n; i++) {
+        at += charUs; ///< Cada byte está disponible al terminar su último bit
+        u.rx.push_back(std::make_pair(at, data[i]));
+    }
+}
+
+int SimBoard::serialAvailable(uint8_t port) const {
+    const Uart& u = uart[port];
+    int n = 0;
+    for (size_t i = 0; i < u.rx.size() && u.rx[i].first <= clockUs; i++) n++;
+    return n > 63 ? 63 : n; ///< Buffer de recepción de 64 bytes
+}
+
+int SimBoard::serialRead(uint8_t port) {
+    Uart& u = uart[port];
+    if (u.rx.empty() || u.rx.front().first > clockUs) return -1;
+    uint8_t c = u.rx.front().second;
+    u.rx.pop_front();
+    return c;
+}
+
+// Funciones de Arduino
+
+unsigned long millis() { return (unsigned long)(board.nowUs() / 1000); }
+unsigned long micros() { return (unsigned long)board.nowUs(); }
+void delay(unsigned long ms) { board.advanceUs((uint64_t)ms * 1000); }
+
+void delayMicroseconds(unsigned int us) {
+    board.advanceUs(us);
+    board.settleMatrix(); ///< Las líneas del teclado se asientan durante la espera
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { board.pinModeCall(pin, mode); }
+void digitalWrite(uint8_t pin, uint8_t val) { board.digitalWriteCall(pin, val); }
+int digitalRead(uint8_t pin) { return simPin[pin] ? HIGH : LOW; }
+int analogRead(uint8_t pin) { return board.analogReadCall(pin); }
+void analogWrite(uint8_t pin, int val) { board.digitalWriteCall(pin, val >= 128); }
+
+void tone(uint8_t, unsigned int frequency, unsigned long) { board.toneCall(frequency); }
+void noTone(uint8_t) { board.toneCall(0); }
+
+size_t Print::printFormat(const char* fmt, ...) {
+    char buf[32];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return n > 0 ? write(buf) : 0;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint8_t config) {
+    uint8_t bits = 1 + 8 + ((config & 0x30) ? 1 : 0) + ((config & 0x08) ? 2 : 1); ///< Inicio, datos, paridad y parada
+    board.serialBegin(port, baud, bits);
+}
+int HardwareSerial::availableForWrite() { return board.serialAvailableForWrite(port); }
+size_t HardwareSerial::write(uint8_t c) { return board.serialWrite(port, c) ? 1 : 0; }
+int HardwareSerial::available() { return board.serialAvailable(port); }
+int HardwareSerial::read() { return board.serialRead(port); }
+
+// Controladores simulados
+
+bool DHT::read(bool) {
+    ok = board.dhtRead(temperature, humidity);
+    return ok;
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force) {
+    if (force) read(true); ///< Sin force se reutiliza la última transacción, como la librería
+    if (!ok) return NAN;
+    return fahrenheit ? temperature * 1.8f + 32 : temperature;
+}
+
+float DHT::readHumidity(bool force) {
+    if (force) read(true);
+    return ok ? humidity : NAN;
+}
+
+LiquidCrystal::LiquidCrystal(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t)
+    : numCols(16), numRows(2), col(0), row(0), writeCount(0) {
+    memset(ddram, ' ', sizeof(ddram));
+    memset(cgram, 0, sizeof(cgram));
+}
+
+void LiquidCrystal::begin(uint8_t cols, uint8_t rows) {
+    numCols = cols > MAX_COLS ? MAX_COLS : cols;
+    numRows = rows > MAX_ROWS ? MAX_ROWS : rows;
+    clear();
+    simLcd = this;
+}
+
+void LiquidCrystal::clear() {
+    memset(ddram, ' ', sizeof(ddram));
+    col = row = 0;
+}
+
+void LiquidCrystal::setCursor(uint8_t c, uint8_t r) {
+    col = c;
+    row = r >= numRows ? numRows - 1 : r; ///< El HD44780 no tiene más filas
+}
+
+void LiquidCrystal::createChar(uint8_t location, uint8_t charmap[]) {
+    memcpy(cgram[location & 7], charmap, 8);
+}
+
+size_t LiquidCrystal::write(uint8_t c) {
+    writeCount++;
+    if (col < numCols) ddram[row][col] = (char)c; ///< Lo que queda fuera de la fila no se ve
+    col++;
+    return 1;
+}
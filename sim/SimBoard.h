@@ -0,0 +1,105 @@
+/**
+ * @file SimBoard.h
+ * @brief Modelo de la placa para la simulación en el host.
+ *
+ * Lleva el reloj virtual y el estado de pines, ADC, buzzer, UART, teclado
+ * y DHT. Las funciones de Arduino simuladas leen y escriben este estado;
+ * el guion de la simulación lo modifica con los métodos set*() y press().
+ */
+
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Placa simulada.
+ */
+class SimBoard {
+public:
+    static const uint8_t MATRIX_ROWS = 4; ///< Filas del teclado matricial
+    static const uint8_t MATRIX_COLS = 4; ///< Columnas del teclado matricial
+    static const uint8_t UARTS = 2; ///< Serial y Serial1
+
+    typedef void (*PinChangeFn)(); ///< Equivalente a la ISR de cambio de pin
+
+    SimBoard();
+
+    // Reloj virtual
+    uint64_t nowUs() const { return clockUs; } ///< Tiempo simulado en µs
+    void advanceUs(uint64_t us); ///< Avanza el reloj (y vacía la UART)
+
+    // Entradas que controla el guion
+    void setDigital(uint8_t pin, uint8_t level); ///< Fija el nivel de un pin de entrada
+    void setAnalog(uint8_t pin, uint16_t value); ///< Fija la lectura del ADC de un pin
+    void setDht(float temperature, float humidity); ///< Próxima lectura correcta del DHT
+    void failDht(); ///< Las próximas lecturas del DHT fallan
+    void serialInject(uint8_t port, const uint8_t* data, size_t n); ///< Bytes que llegan a la línea desde ahora
+
+    /**
+     * @brief Conecta el teclado matricial simulado.
+     *
+     * @param keymap Mapa de teclas (MATRIX_ROWS × MATRIX_COLS).
+     * @param rowPins Pines de las filas.
+     * @param colPins Pines de las columnas.
+     */
+    void attachKeypad(const char* keymap, const byte* rowPins, const byte* colPins);
+    bool press(char key); ///< Mantiene presionada una tecla; false si no existe
+    void release(char key); ///< Suelta una tecla
+    void settleMatrix(); ///< Recalcula las filas según las columnas activas
+
+    void onPinChange(PinChangeFn fn) { pinChange = fn; } ///< Se llama en cada cambio de entrada
+
+    // Salidas que observa la simulación
+    uint8_t output(uint8_t pin) const { return simPort[pin] ? HIGH : LOW; } ///< Nivel escrito en un pin
+    unsigned int toneHz() const { return toneFreq; } ///< Frecuencia del buzzer (0 = apagado)
+    std::vector<uint8_t>& serialOut(uint8_t port = 0) { return uart[port].txLog; } ///< Bytes enviados por una UART
+    unsigned long analogReads() const { return adcReads; } ///< Llamadas a analogRead()
+    uint16_t adcLevel(uint8_t pin) const { return adc[pin < A0 ? pin + A0 : pin]; } ///< Tensión actual en cuentas
+
+    // Llamadas desde las funciones de Arduino simuladas
+    void pinModeCall(uint8_t pin, uint8_t mode);
+    void digitalWriteCall(uint8_t pin, uint8_t val);
+    int analogReadCall(uint8_t pin);
+    void toneCall(unsigned int frequency) { toneFreq = frequency; }
+    bool dhtRead(float& temperature, float& humidity);
+    void serialBegin(uint8_t port, unsigned long baud, uint8_t bitsPerChar);
+    int serialAvailableForWrite(uint8_t port) const;
+    bool serialWrite(uint8_t port, uint8_t c);
+    int serialAvailable(uint8_t port) const;
+    int serialRead(uint8_t port);
+
+private:
+    uint64_t clockUs;
+    uint16_t adc[NUM_DIGITAL_PINS];
+    unsigned long adcReads;
+    unsigned int toneFreq;
+    PinChangeFn pinChange;
+
+    bool dhtOk;
+    float dhtTemperature, dhtHumidity;
+
+    const char* keymap;
+    byte rowPins[MATRIX_ROWS], colPins[MATRIX_COLS];
+    uint16_t pressed; ///< Bit r * MATRIX_COLS + c por tecla presionada
+
+    /**
+     * @brief Estado de una UART.
+     */
+    struct Uart {
+        unsigned long baud;
+        uint8_t bits; ///< Bits por carácter en la línea
+        int txQueued; ///< Bytes en el buffer de transmisión
+        uint64_t txElapsedUs; ///< Tiempo de línea aún no convertido en bytes enviados
+        std::vector<uint8_t> txLog;
+        std::deque<std::pair<uint64_t, uint8_t> > rx; ///< Bytes por llegar con su instante
+    };
+    Uart uart[UARTS];
+};
+
+extern SimBoard board; ///< Placa simulada
+
+#endif
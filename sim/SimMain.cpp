@@ -0,0 +1,741 @@
+/**
+ * @file SimMain.cpp
+ * @brief Ejecuta el firmware en el host siguiendo un guion de entradas.
+ *
+ * Uso: `proyecto_sim [-v] [-j informe.json] [-l registro.txt] guion.txt`
+ *
+ * El guion es un archivo de texto con un evento por línea, ordenado o no,
+ * con el instante en milisegundos al principio. `#` inicia un comentario,
+ * salvo cuando es la tecla de un evento de teclado.
+ *
+ *     <ms> key <tecla> [ms]     presiona una tecla y la suelta tras [ms] (150)
+ *     <ms> press <tecla>        mantiene presionada una tecla
+ *     <ms> release <tecla>      suelta una tecla
+ *     <ms> pin <pin> <0|1>      fija el nivel de una entrada digital
+ *     <ms> adc <pin> <valor>    fija la lectura del ADC (0–1023) de un pin
+ *     <ms> dht <°C> <%>         próximas lecturas del DHT
+ *     <ms> dht fail             las próximas lecturas del DHT fallan
+ *     <ms> bus <hex> ...        trama Modbus hacia Serial1 (se agrega el CRC)
+ *     <ms> sample <T> <H> <LF>  muestra del registro de telemetría (ver abajo)
+ *     <ms> limit <métrica> <v>  la métrica no debe pasar de v
+ *     <ms> require <métrica> <v> la métrica debe llegar al menos a v
+ *     <ms> end                  termina la simulación
+ *
+ * `sample` reproduce una muestra grabada por TelemetryLog con sus campos
+ * crudos: `tempCenti`, `humCenti` y `lightFlags` (admite 0x...). Fija la
+ * próxima lectura del DHT (o su falla si la muestra no era válida) y el
+ * ADC del fotoresistor, y si la muestra tiene las banderas de infrarrojo
+ * o Hall genera un pulso de `REPLAY_PULSE_US` en ese pin. `-l` escribe en
+ * este formato las páginas que quedaron en la EEPROM simulada, de modo que
+ * un registro se puede volver a reproducir contra otra versión del
+ * firmware; el instante de cada muestra es su tiempo encendido.
+ *
+ * `limit` y `require` comparan al final una métrica del resumen (el
+ * instante se ignora):
+ *
+ *     max_loop_us        iteración de loop() más larga (solo lo que bloquea)
+ *     key_to_lcd_ms      mayor demora entre una tecla y el siguiente cambio del LCD
+ *     time_to_alarm_ms   mayor demora entre el último cambio de `dht` y la alarma
+ *     alarms             entradas al estado de alarma
+ *     missed_edges       pulsos infrarrojos y Hall del guion que el firmware no contó
+ *     keys_unanswered    teclas sin cambio del LCD dentro de `KEY_TIMEOUT_US`
+ *     dropped_frames     tramas descartadas o con error
+ *
+ * Si alguna no se cumple el programa termina con código 1. `-j` escribe
+ * el resumen, las métricas y cada comparación en JSON, para comparar
+ * corridas entre versiones del firmware.
+ *
+ * El reloj es virtual: entre iteraciones de loop() salta directamente al
+ * próximo plazo del planificador, al próximo barrido del teclado o al
+ * próximo evento del guion, así que una hora de uso se simula en una
+ * fracción de segundo. Cada cambio observable se escribe en una línea:
+ *
+ *     <ms> lcd <fila> "<texto>"
+ *     <ms> pin <pin> <nivel>
+ *     <ms> tone <Hz>
+ *     <ms> state <anterior> <nuevo>
+ *     <ms> serial "<línea>"        texto por la UART (banco de pruebas)
+ *     <ms> bus <hex> ...           bytes enviados por Serial1 (RS-485)
+ *     <ms> frame <tipo> ...        (solo con -v)
+ *
+ * Al final se agrega un resumen en líneas que empiezan con `#`.
+ * Para medir la demora de la alarma, la simulación reconoce el estado por
+ * su número en las tramas de transición (`STATE_ALARMA`).
+ */
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+#include <EEPROM.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "SimBoard.h"
+#include "../AdcSampler.h"
+#include "../BoardProfile.h"
+#include "../Scheduler.h"
+#include "../KeypadScanner.h"
+#include "../LedAnimator.h"
+#include "../PinEvents.h"
+#include "../PowerManager.h"
+#include "../SensorBus.h"
+#include "../TelemetryLog.h"
+#include "../TelemetryStream.h"
+
+void setup();
+void loop();
+
+extern char keys[SimBoard::MATRIX_ROWS][SimBoard::MATRIX_COLS];
+extern byte rowPins[SimBoard::MATRIX_ROWS];
+extern byte colPins[SimBoard::MATRIX_COLS];
+extern unsigned int irEventos;
+extern unsigned int hallEventos;
+extern TelemetryLog telemetria;
+
+static const uint64_t SCAN_US = 1000000 / KeypadScanner::SCAN_HZ; ///< Periodo de la ISR del Timer3
+static const uint64_t LED_US = LedAnimator::FRAME_MS * 1000; ///< Un periodo de PWM de la ISR del Timer4
+static const uint64_t ADC_US = 1024; ///< Desborde del Timer0 (64 · 256 ciclos): dispara el ADC
+static const uint64_t TAIL_US = 1000000; ///< Tiempo simulado tras el último evento si no hay `end`
+static const uint64_t REPLAY_PULSE_US = 100000; ///< Pulso infrarrojo o Hall de una muestra reproducida
+static const uint64_t KEY_TIMEOUT_US = 1000000; ///< Una tecla sin cambio del LCD en este plazo no tuvo respuesta
+static const uint8_t STATE_ALARMA = 2; ///< `State::Alarma` en Documentacion.cpp
+
+/**
+ * @brief Evento del guion.
+ */
+struct TraceEvent {
+    enum Kind { PRESS, RELEASE, PIN, ADC, DHT_OK, DHT_FAIL, BUS, END };
+
+    uint64_t atUs; ///< Instante del evento
+    Kind kind;
+    int pin; ///< Pin o tecla
+    float a, b; ///< Nivel, lectura o temperatura y humedad
+    std::vector<uint8_t> bytes; ///< Trama del bus, con el CRC
+};
+
+/**
+ * @brief Comparación de `limit` o `require`.
+ */
+struct TraceLimit {
+    std::string metric;
+    bool atMost; ///< `limit`: no debe pasar de bound; `require`: al menos bound
+    double bound;
+};
+
+static const char* const METRICS[] = {"max_loop_us", "key_to_lcd_ms", "time_to_alarm_ms", "alarms",
+                                      "missed_edges", "keys_unanswered", "dropped_frames"};
+
+static bool knownMetric(const char* name) {
+    for (size_t i = 0; i < sizeof(METRICS) / sizeof(METRICS[0]); i++) {
+        if (!strcmp(name, METRICS[i])) return true;
+    }
+    return false;
+}
+
+static bool byTime(const TraceEvent& x, const TraceEvent& y) {
+    return x.atUs < y.atUs;
+}
+
+/**
+ * @brief Convierte una muestra del registro en eventos de DHT, ADC y pines.
+ */
+static void expandSample(TraceEvent e, int temp, int hum, int lightFlags, std::vector<TraceEvent>& events) {
+    e.kind = (lightFlags & TelemetryRecord::FLAG_DHT_VALID) ? TraceEvent::DHT_OK : TraceEvent::DHT_FAIL;
+    e.a = temp / 100.0f;
+    e.b = hum / 100.0f;
+    events.push_back(e);
+
+    e.kind = TraceEvent::ADC;
+    e.pin = Board::PHOTO_RESISTOR;
+    e.a = lightFlags & TelemetryRecord::LIGHT_MASK;
+    events.push_back(e);
+
+    const uint16_t flags[] = {TelemetryRecord::FLAG_IR, TelemetryRecord::FLAG_HALL};
+    const int pins[] = {Board::INFRARED, Board::HALL};
+    for (uint8_t i = 0; i < 2; i++) {
+        if (!(lightFlags & flags[i])) continue;
+        TraceEvent edge = e;
+        edge.kind = TraceEvent::PIN;
+        edge.pin = pins[i];
+        edge.a = 1;
+        events.push_back(edge); ///< Pulso completo: la muestra solo dice que hubo flanco
+        edge.atUs += REPLAY_PULSE_US;
+        edge.a = 0;
+        events.push_back(edge);
+    }
+}
+
+/**
+ * @brief Lee el guion. Devuelve false ante una línea inválida.
+ */
+static bool loadTrace(const char* path, std::vector<TraceEvent>& events, std::vector<TraceLimit>& limits) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "no se pudo abrir %s\n", path);
+        return false;
+    }
+    char line[128];
+    unsigned lineNo = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        const char* first = line + strspn(line, " \t");
+        if (*first == '#' || strspn(first, "\r\n") == strlen(first)) continue; ///< Comentario o línea vacía
+
+        double ms;
+        char cmd[16];
+        int consumed = 0;
+        if (sscanf(line, " %lf %15s %n", &ms, cmd, &consumed) < 2) {
+            fprintf(stderr, "%s:%u: línea inválida\n", path, lineNo);
+            ok = false;
+            continue;
+        }
+        char* rest = line + consumed;
+        bool keyCmd = !strcmp(cmd, "key") || !strcmp(cmd, "press") || !strcmp(cmd, "release");
+        char key = keyCmd ? *rest : 0; ///< La tecla se toma literal: `#` y `*` son teclas válidas
+        if (keyCmd && key) rest++;
+        char* hash = strchr(rest, '#');
+        if (hash) *hash = '\0'; ///< Comentario al final de la línea
+
+        TraceEvent e = {(uint64_t)(ms * 1000), TraceEvent::END, key, 0, 0, std::vector<uint8_t>()};
+        float holdMs = 150;
+        int temp, hum, lightFlags; ///< Campos de `sample`
+        bool valid = true;
+
+        if (keyCmd && (key == 0 || key == '\n' || key == '\r')) {
+            valid = false;
+        } else if (!strcmp(cmd, "key")) {
+            sscanf(rest, "%f", &holdMs);
+            e.kind = TraceEvent::PRESS;
+            events.push_back(e);
+            e.kind = TraceEvent::RELEASE;
+            e.atUs += (uint64_t)(holdMs * 1000);
+        } else if (!strcmp(cmd, "press")) {
+            e.kind = TraceEvent::PRESS;
+        } else if (!strcmp(cmd, "release")) {
+            e.kind = TraceEvent::RELEASE;
+        } else if (!strcmp(cmd, "pin") && sscanf(rest, "%d %f", &e.pin, &e.a) == 2) {
+            e.kind = TraceEvent::PIN;
+        } else if (!strcmp(cmd, "adc") && sscanf(rest, "%d %f", &e.pin, &e.a) == 2) {
+            e.kind = TraceEvent::ADC;
+        } else if (!strcmp(cmd, "dht") && strstr(rest, "fail")) {
+            e.kind = TraceEvent::DHT_FAIL;
+        } else if (!strcmp(cmd, "dht") && sscanf(rest, "%f %f", &e.a, &e.b) == 2) {
+            e.kind = TraceEvent::DHT_OK;
+        } else if (!strcmp(cmd, "bus")) {
+            unsigned value;
+            int used;
+            for (const char* p = rest; sscanf(p, "%x%n", &value, &used) == 1 && value <= 0xFF; p += used) {
+                e.bytes.push_back((uint8_t)value);
+            }
+            uint16_t crc = SensorBus::crc16(e.bytes.data(), e.bytes.size());
+            e.bytes.push_back(crc & 0xFF);
+            e.bytes.push_back(crc >> 8);
+            e.kind = TraceEvent::BUS;
+            valid = e.bytes.size() > 2;
+        } else if (!strcmp(cmd, "sample") && sscanf(rest, "%i %i %i", &temp, &hum, &lightFlags) == 3) {
+            expandSample(e, temp, hum, lightFlags, events);
+            continue; ///< Ya agregó sus eventos
+        } else if (!strcmp(cmd, "limit") || !strcmp(cmd, "require")) {
+            char metric[24];
+            TraceLimit l;
+            valid = sscanf(rest, "%23s %lf", metric, &l.bound) == 2 && knownMetric(metric);
+            if (valid) {
+                l.metric = metric;
+                l.atMost = !strcmp(cmd, "limit");
+                limits.push_back(l);
+                continue; ///< No es un evento
+            }
+        } else if (!strcmp(cmd, "end")) {
+            e.kind = TraceEvent::END;
+        } else {
+            valid = false;
+        }
+        if (valid && (e.kind == TraceEvent::PIN || e.kind == TraceEvent::ADC) &&
+            (e.pin < 0 || e.pin >= NUM_DIGITAL_PINS)) {
+            valid = false;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "%s:%u: evento inválido: %s", path, lineNo, line);
+            ok = false;
+            continue;
+        }
+        events.push_back(e);
+    }
+    fclose(f);
+    std::stable_sort(events.begin(), events.end(), byTime);
+    return ok;
+}
+
+/**
+ * @brief Métricas de tiempo de la corrida (ver `limit`).
+ */
+class Metrics {
+public:
+    Metrics()
+        : loopMaxUs(0), keyPending(false), keySinceUs(0), keyAnswered(0), keyUnanswered(0), keyMaxUs(0),
+          keySumUs(0), dhtKnown(false), dhtOk(false), dhtT(0), dhtH(0), dhtChangeUs(0), alarmCount(0),
+          alarmMaxUs(0), irPulses(0), hallPulses(0) {
+        memset(levels, 0, sizeof(levels));
+    }
+
+    void keyPressed(uint64_t us) {
+        if (keyPending) keyUnanswered++; ///< La anterior no llegó a cambiar el LCD
+        keyPending = true;
+        keySinceUs = us;
+    }
+
+    void lcdChanged(uint64_t us) {
+        if (!keyPending) return;
+        uint64_t latency = us - keySinceUs;
+        keyPending = false;
+        keyAnswered++;
+        keySumUs += latency;
+        keyMaxUs = std::max(keyMaxUs, latency);
+    }
+
+    void expire(uint64_t us) {
+        if (keyPending && us - keySinceUs > KEY_TIMEOUT_US) {
+            keyPending = false;
+            keyUnanswered++;
+        }
+    }
+
+    void pinSet(int pin, bool level) {
+        if (level && !levels[pin]) { ///< Flanco de subida inyectado
+            if (pin == Board::INFRARED) irPulses++;
+            if (pin == Board::HALL) hallPulses++;
+        }
+        levels[pin] = level;
+    }
+
+    void dhtSet(bool ok, float t, float h, uint64_t us) {
+        if (dhtKnown && ok == dhtOk && (!ok || (t == dhtT && h == dhtH))) return; ///< Misma lectura
+        dhtKnown = true;
+        dhtOk = ok;
+        dhtT = t;
+        dhtH = h;
+        dhtChangeUs = us;
+    }
+
+    void stateEntered(uint8_t state, uint64_t us) {
+        if (state != STATE_ALARMA) return;
+        alarmCount++;
+        alarmMaxUs = std::max(alarmMaxUs, us - dhtChangeUs);
+    }
+
+    unsigned int missedEdges() const {
+        unsigned int missed = 0;
+        if (irPulses > irEventos) missed += irPulses - irEventos;
+        if (hallPulses > hallEventos) missed += hallPulses - hallEventos;
+        return missed;
+    }
+
+    double keyMeanMs() const { return keyAnswered ? keySumUs / 1000.0 / keyAnswered : 0; }
+
+    /**
+     * @brief Valor de una métrica por su nombre (ver `METRICS`).
+     */
+    double value(const std::string& metric, unsigned long droppedFrames) const {
+        if (metric == "max_loop_us") return (double)loopMaxUs;
+        if (metric == "key_to_lcd_ms") return keyMaxUs / 1000.0;
+        if (metric == "time_to_alarm_ms") return alarmMaxUs / 1000.0;
+        if (metric == "alarms") return alarmCount;
+        if (metric == "missed_edges") return missedEdges();
+        if (metric == "keys_unanswered") return keyUnanswered;
+        return droppedFrames; ///< dropped_frames
+    }
+
+    uint64_t loopMaxUs; ///< Iteración más larga de loop()
+    bool keyPending; ///< Hay una tecla esperando un cambio del LCD
+    uint64_t keySinceUs;
+    unsigned long keyAnswered, keyUnanswered;
+    uint64_t keyMaxUs, keySumUs;
+    bool dhtKnown, dhtOk; ///< Última lectura fijada por el guion
+    float dhtT, dhtH;
+    uint64_t dhtChangeUs; ///< Instante en que cambió la lectura del DHT
+    unsigned long alarmCount;
+    uint64_t alarmMaxUs;
+    unsigned int irPulses, hallPulses; ///< Pulsos inyectados
+    uint8_t levels[NUM_DIGITAL_PINS]; ///< Nivel inyectado en cada pin
+};
+
+static Metrics metrics;
+
+/**
+ * @brief Aplica un evento del guion a la placa.
+ *
+ * @return false si el evento termina la simulación.
+ */
+static bool apply(const TraceEvent& e) {
+    switch (e.kind) {
+    case TraceEvent::PRESS:
+        if (!board.press((char)e.pin)) fprintf(stderr, "tecla desconocida: %c\n", e.pin);
+        metrics.keyPressed(board.nowUs());
+        break;
+    case TraceEvent::RELEASE: board.release((char)e.pin); break;
+    case TraceEvent::PIN:
+        board.setDigital(e.pin, e.a != 0);
+        metrics.pinSet(e.pin, e.a != 0);
+        break;
+    case TraceEvent::ADC: board.setAnalog(e.pin, (uint16_t)e.a); break;
+    case TraceEvent::DHT_OK:
+        board.setDht(e.a, e.b);
+        metrics.dhtSet(true, e.a, e.b, board.nowUs());
+        break;
+    case TraceEvent::DHT_FAIL:
+        board.failDht();
+        metrics.dhtSet(false, 0, 0, board.nowUs());
+        break;
+    case TraceEvent::BUS: board.serialInject(1, e.bytes.data(), e.bytes.size()); break;
+    case TraceEvent::END: return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Cambios observables desde la última iteración.
+ */
+class Observer {
+public:
+    explicit Observer(bool verbose) : verbose(verbose), toneHz(0), frames(0), badFrames(0), parsed(0) {
+        memset(lcd, 0, sizeof(lcd));
+        memset(levels, 0, sizeof(levels));
+        memset(watched, 1, sizeof(watched));
+        for (uint8_t i = 0; i < SimBoard::MATRIX_ROWS; i++) watched[rowPins[i]] = false;
+        for (uint8_t i = 0; i < SimBoard::MATRIX_COLS; i++) watched[colPins[i]] = false;
+    }
+
+    void report() {
+        unsigned long ms = millis();
+        if (simLcd) {
+            for (uint8_t r = 0; r < simLcd->rows(); r++) {
+                char text[LiquidCrystal::MAX_COLS + 1];
+                for (uint8_t c = 0; c < simLcd->cols(); c++) {
+                    char ch = simLcd->charAt(c, r);
+                    text[c] = (ch >= ' ' && ch < 0x7F) ? ch : '?'; ///< Caracteres propios y no ASCII
+                }
+                text[simLcd->cols()] = '\0';
+                if (strcmp(text, lcd[r])) {
+                    strcpy(lcd[r], text);
+                    metrics.lcdChanged(board.nowUs());
+                    printf("%8lu lcd %u \"%s\"\n", ms, r, text);
+                }
+            }
+        }
+        for (uint8_t p = 0; p < NUM_DIGITAL_PINS; p++) {
+            if (!watched[p] || !simDdr[p]) continue;
+            uint8_t level = board.output(p);
+            if (level != levels[p]) {
+                levels[p] = level;
+                printf("%8lu pin %u %u\n", ms, p, level);
+            }
+        }
+        if (board.toneHz() != toneHz) {
+            toneHz = board.toneHz();
+            printf("%8lu tone %u\n", ms, toneHz);
+        }
+        decodeFrames(ms);
+
+        std::vector<uint8_t>& busOut = board.serialOut(1);
+        if (!busOut.empty()) {
+            printf("%8lu bus", ms);
+            for (size_t i = 0; i < busOut.size(); i++) printf(" %02X", busOut[i]);
+            printf("\n");
+            busOut.clear();
+        }
+    }
+
+    unsigned long frameCount() const { return frames; }
+    unsigned long badFrameCount() const { return badFrames; }
+
+private:
+    /**
+     * @brief Decodifica las tramas COBS completas que salieron por la UART.
+     */
+    void decodeFrames(unsigned long ms) {
+        std::vector<uint8_t>& out = board.serialOut();
+        size_t start = 0;
+
+        // Líneas de texto (banco de pruebas): nunca empiezan con un código COBS (< 0x20).
+        while (start < out.size() && out[start] >= ' ') {
+            size_t eol = start;
+            while (eol < out.size() && out[eol] != '\n' && out[eol] != 0x00) eol++;
+            if (eol == out.size() || out[eol] != '\n') break; ///< Línea incompleta o no es texto
+            size_t end = eol;
+            if (end > start && out[end - 1] == '\r') end--;
+            printf("%8lu serial \"%.*s\"\n", ms, (int)(end - start), (const char*)&out[start]);
+            start = eol + 1;
+        }
+        if (parsed < start) parsed = start;
+        for (size_t i = parsed; i < out.size(); i++) {
+            if (out[i] != 0x00) continue;
+            uint8_t payload[TelemetryStream::PAYLOAD_BYTES];
+            size_t n = cobsDecode(&out[start], i - start, payload, sizeof(payload));
+            start = i + 1;
+            if (n != sizeof(payload)) {
+                badFrames++;
+                continue;
+            }
+            uint16_t crc = TelemetryStream::crc16(payload, sizeof(TelemetryFrame));
+            if (payload[sizeof(TelemetryFrame)] != (crc >> 8) || payload[sizeof(TelemetryFrame) + 1] != (crc & 0xFF)) {
+                badFrames++;
+                continue;
+            }
+            TelemetryFrame f;
+            memcpy(&f, payload, sizeof(f));
+            frames++;
+            if (f.type == TelemetryFrame::TRANSITION) {
+                printf("%8lu state %u %u\n", ms, f.state >> 4, f.state & 0x0F);
+                metrics.stateEntered(f.state & 0x0F, board.nowUs());
+            }
+            if (verbose) {
+                printf("%8lu frame %u seq=%u t=%lu temp=%d hum=%u light=%u flags=0x%02X state=0x%02X\n", ms,
+                       f.type, f.seq, (unsigned long)f.timeMs, f.tempCenti, f.humCenti, f.light, f.flags, f.state);
+            }
+        }
+        out.erase(out.begin(), out.begin() + start); ///< Queda solo la trama incompleta
+        parsed = out.size();
+    }
+
+    static size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+        size_t o = 0;
+        for (size_t i = 0; i < length;) {
+            uint8_t code = in[i++];
+            if (code == 0) return 0;
+            for (uint8_t k = 1; k < code; k++) {
+                if (i >= length || o >= capacity) return 0;
+                out[o++] = in[i++];
+            }
+            if (code != 0xFF && i < length) {
+                if (o >= capacity) return 0;
+                out[o++] = 0x00;
+            }
+        }
+        return o;
+    }
+
+    bool verbose;
+    char lcd[LiquidCrystal::MAX_ROWS][LiquidCrystal::MAX_COLS + 1];
+    uint8_t levels[NUM_DIGITAL_PINS];
+    bool watched[NUM_DIGITAL_PINS]; ///< Las líneas del teclado cambian en cada barrido
+    unsigned int toneHz;
+    unsigned long frames, badFrames;
+    size_t parsed; ///< Bytes de la UART ya revisados
+};
+
+/**
+ * @brief Escribe una cadena JSON (los nombres del firmware son ASCII).
+ */
+static void jsonString(FILE* f, const char* text) {
+    fputc('"', f);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', f);
+        fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+/**
+ * @brief Escribe el resumen, las métricas y las comparaciones en JSON.
+ */
+static bool writeReport(const char* reportPath, const char* tracePath, double simMs, double wallMs,
+                        unsigned long loops, const Observer& observer, const std::vector<TraceLimit>& limits,
+                        const std::vector<bool>& passed) {
+    FILE* f = fopen(reportPath, "w");
+    if (!f) {
+        fprintf(stderr, "no se pudo crear %s\n", reportPath);
+        return false;
+    }
+    unsigned long dropped = stream.dropped() + observer.badFrameCount();
+    bool allPassed = true;
+    for (size_t i = 0; i < passed.size(); i++) allPassed = allPassed && passed[i];
+
+    fprintf(f, "{\n  \"trace\": ");
+    jsonString(f, tracePath);
+    fprintf(f, ",\n  \"pass\": %s,\n", allPassed ? "true" : "false");
+    fprintf(f, "  \"sim_ms\": %.0f,\n  \"wall_ms\": %.1f,\n  \"loops\": %lu,\n", simMs, wallMs, loops);
+    fprintf(f, "  \"metrics\": {\n");
+    for (size_t i = 0; i < sizeof(METRICS) / sizeof(METRICS[0]); i++) {
+        fprintf(f, "    \"%s\": %g,\n", METRICS[i], metrics.value(METRICS[i], dropped));
+    }
+    fprintf(f, "    \"key_to_lcd_mean_ms\": %.1f,\n    \"keys_answered\": %lu,\n", metrics.keyMeanMs(),
+            metrics.keyAnswered);
+    fprintf(f, "    \"ir_pulses\": %u,\n    \"ir_counted\": %u,\n", metrics.irPulses, irEventos);
+    fprintf(f, "    \"hall_pulses\": %u,\n    \"hall_counted\": %u,\n", metrics.hallPulses, hallEventos);
+    fprintf(f, "    \"frames\": %lu,\n    \"eeprom_writes\": %lu,\n", observer.frameCount(), EEPROM.writeCount);
+    fprintf(f, "    \"idle_ms\": %lu,\n    \"idle_pct\": %u,\n    \"estimated_mah\": %.2f,\n", power.idleMs(),
+            (unsigned)power.idlePercent(), power.estimatedMah());
+    fprintf(f, "    \"key_overflows\": %u,\n    \"pin_overflows\": %u\n  },\n", (unsigned)keypad.overflows(),
+            (unsigned)pinEvents.overflows());
+    fprintf(f, "  \"tasks\": [");
+    for (uint8_t i = 0; i < scheduler.count(); i++) {
+        const Scheduler::Task& t = scheduler.task(i);
+        fprintf(f, "%s\n    {\"name\": ", i ? "," : "");
+        jsonString(f, t.name);
+        fprintf(f, ", \"max_us\": %lu, \"overruns\": %u}", t.maxRunUs, t.overruns);
+    }
+    fprintf(f, "\n  ],\n  \"limits\": [");
+    for (size_t i = 0; i < limits.size(); i++) {
+        const TraceLimit& l = limits[i];
+        fprintf(f, "%s\n    {\"metric\": \"%s\", \"kind\": \"%s\", \"bound\": %g, \"value\": %g, \"pass\": %s}",
+                i ? "," : "", l.metric.c_str(), l.atMost ? "limit" : "require", l.bound,
+                metrics.value(l.metric, dropped), passed[i] ? "true" : "false");
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Escribe las páginas del registro que quedaron en la EEPROM como 
+ * líneas `sample`, de la más antigua a la más nueva.
+ */
+static bool dumpLog(const char* logPath) {
+    FILE* f = fopen(logPath, "w");
+    if (!f) {
+        fprintf(stderr, "no se pudo crear %s\n", logPath);
+        return false;
+    }
+    fprintf(f, "# Registro de telemetría: <ms encendido> sample <tempCenti> <humCenti> <lightFlags>\n");
+    TelemetryPageHeader h;
+    TelemetryRecord records[TelemetryLog::PAGE_RECORDS];
+    for (uint8_t age = 0; age < telemetria.pageSlots(); age++) {
+        if (!telemetria.readPage(age, h, records)) continue; ///< Página vacía o dañada
+        unsigned long ms = h.baseS * 1000UL;
+        for (uint8_t i = 0; i < h.count; i++) {
+            if (i) ms += records[i].deltaDs * 100UL; ///< La primera muestra está en baseS
+            fprintf(f, "%lu sample %d %u 0x%04X\n", ms, records[i].tempCenti, records[i].humCenti,
+                    records[i].lightFlags);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static void pinChangeIsr() {
+    pinEvents.handleChange();
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    const char* path = 0;
+    const char* reportPath = 0;
+    const char* logPath = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v")) verbose = true;
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc) reportPath = argv[++i];
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc) logPath = argv[++i];
+        else path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "uso: %s [-v] [-j informe.json] [-l registro.txt] guion.txt\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<TraceEvent> events;
+    std::vector<TraceLimit> limits;
+    if (!loadTrace(path, events, limits)) return 2;
+    uint64_t endUs = events.empty() ? TAIL_US : events.back().atUs + TAIL_US;
+    for (size_t i = 0; i < events.size(); i++) {
+        if (events[i].kind == TraceEvent::END) {
+            endUs = events[i].atUs;
+            break;
+        }
+    }
+
+    board.attachKeypad(&keys[0][0], rowPins, colPins);
+    board.onPinChange(pinChangeIsr);
+
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    setup();
+    Observer observer(verbose);
+    observer.report();
+
+    size_t next = 0;
+    uint64_t nextScanUs = SCAN_US;
+    uint64_t nextLedUs = LED_US;
+    uint64_t nextAdcUs = board.nowUs() + ADC_US;
+    unsigned long loops = 0;
+    while (board.nowUs() < endUs) {
+        while (next < events.size() && events[next].atUs <= board.nowUs()) {
+            if (!apply(events[next++])) endUs = board.nowUs();
+        }
+        if (board.nowUs() >= endUs) break;
+        while (nextScanUs <= board.nowUs()) {
+            keypad.scan(); ///< ISR del Timer3
+            nextScanUs += SCAN_US;
+        }
+        while (nextLedUs <= board.nowUs()) {
+            leds.frame(); ///< Sin PWM: un paso de animación por periodo
+            nextLedUs += LED_US;
+        }
+
+        uint64_t loopStartUs = board.nowUs();
+        loop();
+        loops++;
+        metrics.loopMaxUs = std::max(metrics.loopMaxUs, board.nowUs() - loopStartUs); ///< Solo cuenta lo que bloquea (DHT, ADC, UART)
+        metrics.expire(board.nowUs());
+        observer.report();
+
+        // Mismo criterio que power.idle(): dormir hasta el próximo plazo o el tope de reposo.
+        uint64_t wakeUs = ((uint64_t)millis() + scheduler.msUntilNext(power.wakePeriod())) * 1000;
+        wakeUs = std::min(wakeUs, nextScanUs);
+        wakeUs = std::min(wakeUs, nextLedUs);
+        if (next < events.size()) wakeUs = std::min(wakeUs, events[next].atUs);
+        wakeUs = std::min(wakeUs, endUs);
+        if (wakeUs <= board.nowUs()) wakeUs = board.nowUs() + 1;
+        power.accountIdle(wakeUs - board.nowUs()); ///< El reloj salta lo que el AVR dormiría
+        while (nextAdcUs <= wakeUs) { ///< ISR del ADC mientras el bucle duerme
+            board.advanceUs(nextAdcUs - board.nowUs());
+            lightAdc.onConversion(board.adcLevel(lightAdc.pin()));
+            nextAdcUs += ADC_US;
+        }
+        board.advanceUs(wakeUs - board.nowUs());
+    }
+
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    double simMs = board.nowUs() / 1000.0;
+    printf("# sim_ms %.0f\n", simMs);
+    printf("# wall_ms %.1f\n", wallMs);
+    printf("# speedup %.0f\n", wallMs > 0 ? simMs / wallMs : 0.0);
+    printf("# loops %lu\n", loops);
+    printf("# idle_ms %lu pct %u sleeps %lu mah %.2f\n", power.idleMs(), (unsigned)power.idlePercent(),
+           power.sleeps(), power.estimatedMah());
+    printf("# max_loop_us %llu\n", (unsigned long long)metrics.loopMaxUs);
+    printf("# frames %lu bad %lu dropped %u\n", observer.frameCount(), observer.badFrameCount(), stream.dropped());
+    printf("# adc_reads %lu\n", board.analogReads());
+    printf("# eeprom_writes %lu\n", EEPROM.writeCount);
+    printf("# bus served %u crc_errors %u\n", bus.served(), bus.crcErrors());
+    for (uint8_t i = 0; i < bus.nodeCount(); i++) { ///< Solo en el maestro
+        const SensorBus::Node& n = bus.node(i);
+        printf("# node %u online %u misses %u status 0x%04X\n", i + 1, n.online, n.misses, n.regs[SensorBus::REG_STATUS]);
+    }
+    printf("# key_overflows %u pin_overflows %u\n", (unsigned)keypad.overflows(), (unsigned)pinEvents.overflows());
+    for (uint8_t i = 0; i < scheduler.count(); i++) {
+        const Scheduler::Task& t = scheduler.task(i);
+        printf("# task %-10s max_us %6lu overruns %u\n", t.name, t.maxRunUs, t.overruns);
+    }
+    printf("# key_to_lcd_ms n %lu max %.1f mean %.1f unanswered %lu\n", metrics.keyAnswered,
+           metrics.keyMaxUs / 1000.0, metrics.keyMeanMs(), metrics.keyUnanswered);
+    printf("# time_to_alarm_ms n %lu max %.1f\n", metrics.alarmCount, metrics.alarmMaxUs / 1000.0);
+    printf("# edges ir %u/%u hall %u/%u missed %u\n", irEventos, metrics.irPulses, hallEventos,
+           metrics.hallPulses, metrics.missedEdges());
+
+    unsigned long dropped = stream.dropped() + observer.badFrameCount();
+    std::vector<bool> passed;
+    bool allPassed = true;
+    for (size_t i = 0; i < limits.size(); i++) {
+        const TraceLimit& l = limits[i];
+        double v = metrics.value(l.metric, dropped);
+        passed.push_back(l.atMost ? v <= l.bound : v >= l.bound);
+        allPassed = allPassed && passed.back();
+        printf("# %s %s %g value %g %s\n", l.atMost ? "limit" : "require", l.metric.c_str(), l.bound, v,
+               passed.back() ? "ok" : "FALLA");
+    }
+
+    if (reportPath && !writeReport(reportPath, path, simMs, wallMs, loops, observer, limits, passed)) return 2;
+    if (logPath && !dumpLog(logPath)) return 2;
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file Arduino.h
+ * @brief Núcleo de Arduino para la simulación en el host.
+ *
+ * Expone solo lo que usa el firmware. El tiempo, los pines, el ADC, el
+ * buzzer y la UART los modela SimBoard; cada pin es un "puerto" propio
+ * con máscara 1, así que los accesos directos a registros del teclado y
+ * de las interrupciones por cambio de pin también pasan por el modelo.
+ */
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define F_CPU 16000000UL ///< Reloj del ATmega2560
+#define NUM_DIGITAL_PINS 70
+#define A0 54
+#define E2END 0xFFF ///< Última dirección de la EEPROM del ATmega2560
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#define bit(b) (1UL << (b))
+
+extern volatile uint8_t simDdr[NUM_DIGITAL_PINS]; ///< DDRx de cada pin
+extern volatile uint8_t simPort[NUM_DIGITAL_PINS]; ///< PORTx de cada pin
+extern volatile uint8_t simPin[NUM_DIGITAL_PINS]; ///< PINx de cada pin
+
+#define digitalPinToPort(P) (P)
+#define digitalPinToBitMask(P) (1)
+#define portModeRegister(P) (&simDdr[P])
+#define portOutputRegister(P) (&simPort[P])
+#define portInputRegister(P) (&simPin[P])
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+/**
+ * @brief Salida con formato, igual a la de Arduino en lo que se usa.
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printFormat("%d", v); }
+    size_t print(unsigned int v) { return printFormat("%u", v); }
+    size_t print(long v) { return printFormat("%ld", v); }
+    size_t print(unsigned long v) { return printFormat("%lu", v); }
+    size_t print(double v, int digits = 2) { return printFormat("%.*f", digits, v); }
+
+private:
+    size_t printFormat(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#define SERIAL_8N1 0x06
+#define SERIAL_8N2 0x0E
+#define SERIAL_8E1 0x26
+
+/**
+ * @brief UART con el buffer de transmisión de 64 bytes de HardwareSerial.
+ *
+ * Los bytes se vacían al ritmo de la velocidad configurada a medida que
+ * avanza el reloj simulado. Lo que recibe lo inyecta el guion.
+ */
+class HardwareSerial : public Print {
+public:
+    static const int TX_BUFFER_SIZE = 64;
+
+    explicit HardwareSerial(uint8_t port) : port(port) {}
+
+    void begin(unsigned long baud, uint8_t config = SERIAL_8N1);
+    int availableForWrite();
+    size_t write(uint8_t c);
+    using Print::write;
+    int available();
+    int read();
+
+private:
+    uint8_t port; ///< Índice de la UART en la placa simulada
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * @file DHT.h
+ * @brief Sensor DHT simulado: devuelve los valores que fija el guion.
+ */
+
+#ifndef SIM_DHT_H
+#define SIM_DHT_H
+
+#include <Arduino.h>
+
+#define DHT11 11
+#define DHT22 22
+
+class DHT {
+public:
+    static const unsigned long READ_US = 5000; ///< Duración de una transacción real (bloqueante)
+
+    DHT(uint8_t pin, uint8_t type) : pin(pin), type(type), ok(false), temperature(NAN), humidity(NAN) {}
+
+    void begin() {}
+    bool read(bool force = false);
+    float readTemperature(bool fahrenheit = false, bool force = false);
+    float readHumidity(bool force = false);
+
+private:
+    uint8_t pin, type;
+    bool ok; ///< Resultado de la última transacción
+    float temperature, humidity; ///< Valores de la última transacción
+};
+
+#endif
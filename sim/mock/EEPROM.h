@@ -0,0 +1,35 @@
+/**
+ * @file EEPROM.h
+ * @brief EEPROM simulada (4 KB, arranca borrada en 0xFF).
+ */
+
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+#include <Arduino.h>
+
+struct EEPROMClass {
+    uint8_t mem[E2END + 1];
+    unsigned long writeCount; ///< Celdas realmente escritas
+
+    EEPROMClass() : writeCount(0) { memset(mem, 0xFF, sizeof(mem)); }
+
+    uint8_t read(int idx) { return mem[idx]; }
+    void write(int idx, uint8_t val) { mem[idx] = val; writeCount++; }
+    void update(int idx, uint8_t val) { if (mem[idx] != val) write(idx, val); }
+    uint16_t length() { return E2END + 1; }
+
+    template <typename T> T& get(int idx, T& t) {
+        memcpy(&t, mem + idx, sizeof(T));
+        return t;
+    }
+    template <typename T> const T& put(int idx, const T& t) {
+        const uint8_t* p = (const uint8_t*)&t;
+        for (size_t i = 0; i < sizeof(T); i++) update(idx + i, p[i]);
+        return t;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
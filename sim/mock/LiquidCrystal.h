@@ -0,0 +1,44 @@
+/**
+ * @file LiquidCrystal.h
+ * @brief LCD HD44780 simulado: guarda el contenido visible en memoria.
+ */
+
+#ifndef SIM_LIQUID_CRYSTAL_H
+#define SIM_LIQUID_CRYSTAL_H
+
+#include <Arduino.h>
+
+class LiquidCrystal : public Print {
+public:
+    static const uint8_t MAX_COLS = 20;
+    static const uint8_t MAX_ROWS = 4;
+
+    LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7);
+
+    void begin(uint8_t cols, uint8_t rows);
+    void clear();
+    void home() { setCursor(0, 0); }
+    void setCursor(uint8_t col, uint8_t row);
+    void createChar(uint8_t location, uint8_t charmap[]);
+    void display() {}
+    void noDisplay() {}
+    size_t write(uint8_t c);
+    using Print::write;
+
+    uint8_t cols() const { return numCols; } ///< Columnas configuradas
+    uint8_t rows() const { return numRows; } ///< Filas configuradas
+    char charAt(uint8_t col, uint8_t row) const { return ddram[row][col]; } ///< Carácter visible
+    const uint8_t* glyph(uint8_t location) const { return cgram[location & 7]; } ///< Carácter propio
+    unsigned long writes() const { return writeCount; } ///< Caracteres enviados desde begin()
+
+private:
+    uint8_t numCols, numRows;
+    uint8_t col, row;
+    char ddram[MAX_ROWS][MAX_COLS];
+    uint8_t cgram[8][8];
+    unsigned long writeCount;
+};
+
+extern LiquidCrystal* simLcd; ///< Último LCD inicializado, para el registro de la simulación
+
+#endif